@@ -5,12 +5,46 @@
 #ifndef TRANSMISSION_NETWORKS_APP_CACHEABLE_H
 #define TRANSMISSION_NETWORKS_APP_CACHEABLE_H
 
+#include <cstdint>
 #include <functional>
 
 #include "core/abstract/crtp.h"
 #include "core/abstract/observables/Observable.h"
 
 namespace transmission_nets::core::abstract {
+
+    /*
+     * Scope in which each Cacheable passes set_dirty on at most once. Changes notified together, as
+     * parameters::Transaction::commit does, often reach a shared dependent through several of them, and outside a batch
+     * the dependent and everything downstream of it would be invalidated again for each one. A value cleaned within the
+     * batch passes the next set_dirty on as usual.
+     */
+    class DirtyBatch {
+    public:
+        DirtyBatch() noexcept : outer_(current_) {
+            current_ = ++last_;
+        }
+
+        ~DirtyBatch() {
+            current_ = outer_;
+        }
+
+        DirtyBatch(const DirtyBatch&)            = delete;
+        DirtyBatch& operator=(const DirtyBatch&) = delete;
+
+        /**
+         * @brief Id of the innermost open batch on this thread, or 0 outside any batch.
+         */
+        static std::uint64_t current() noexcept {
+            return current_;
+        }
+
+    private:
+        static inline thread_local std::uint64_t current_ = 0;
+        static inline thread_local std::uint64_t last_    = 0;
+        std::uint64_t outer_;
+    };
+
     template<typename T>
     class Cacheable : public crtp<T, Cacheable> {
         using SetDirtyCallbackType = std::function<void()>;
@@ -28,6 +62,8 @@ namespace transmission_nets::core::abstract {
 
     protected:
         bool is_dirty_{true};
+        // Batch in which set_dirty was last passed on
+        std::uint64_t dirty_batch_{0};
     };
 
     template<typename T>
@@ -37,6 +73,11 @@ namespace transmission_nets::core::abstract {
 
     template<typename T>
     void Cacheable<T>::setDirty() noexcept {
+        const std::uint64_t batch = DirtyBatch::current();
+        if (batch != 0 and this->dirty_batch_ == batch and this->underlying().is_dirty_) {
+            return;
+        }
+        this->dirty_batch_ = batch;
         this->underlying().is_dirty_ = true;
         this->notify_set_dirty();
     }
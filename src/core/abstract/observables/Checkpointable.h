@@ -5,6 +5,9 @@
 #ifndef TRANSMISSION_NETWORKS_APP_CHECKPOINTABLE_H
 #define TRANSMISSION_NETWORKS_APP_CHECKPOINTABLE_H
 
+#include <cassert>
+#include <concepts>
+#include <optional>
 #include <utility>
 #include <vector>
 #include <string>
@@ -51,6 +54,16 @@ namespace transmission_nets::core::abstract {
 //         return type_of_impl_<T>();
 //     }
 //
+    /*
+     * Implementations that declare `static constexpr bool deferCheckpoints = true` do not copy their value when it is
+     * saved. The value is copied by checkpointBeforeChange, which they call before every change to value_, so a save
+     * that is followed by no change costs nothing but the saved state id, and restoring it leaves the value untouched.
+     * Debug builds also keep a copy at each save and assert that an empty checkpoint still matches the value, so a change
+     * that skips checkpointBeforeChange fails on the next save, restore or accept instead of corrupting a rejected move.
+     */
+    template<typename T>
+    concept DefersCheckpoints = requires { requires T::deferCheckpoints; };
+
     /*
      * CRTP mixin to enable checkpointing of a value. Allows for the underlying class with field value_ to be saved and restored.
      */
@@ -64,11 +77,18 @@ namespace transmission_nets::core::abstract {
         CRTP_CREATE_EVENT(restore_state, SaveRestoreCallbackType)
 
         struct StateCheckpoint {
-            StateCheckpoint(ValueType savedState, const int savedStateId) : saved_state(savedState), saved_state_id(savedStateId) {};
-            ValueType saved_state;
+            StateCheckpoint(std::optional<ValueType> savedState, const int savedStateId) : saved_state(std::move(savedState)), saved_state_id(savedStateId) {};
+            // Empty for a deferred checkpoint until the value first changes
+            std::optional<ValueType> saved_state;
             int saved_state_id;
+#ifndef NDEBUG
+            // The value at the save, checked against value_ while a deferred checkpoint is empty
+            std::optional<ValueType> debug_state{};
+#endif
         };
 
+        void assertUnchangedSinceCheckpoint() noexcept;
+
         // static constexpr std::string_view checkpointable_type = type_of<T>();
 
     public:
@@ -110,6 +130,12 @@ namespace transmission_nets::core::abstract {
 
         bool constexpr isSaved() noexcept;
 
+        /**
+         * @brief Copy the value into the innermost checkpoint, unless it already holds the value from before the last save.
+         * Implementations that defer checkpoints call this before every change to value_.
+         */
+        void checkpointBeforeChange() noexcept;
+
     protected:
         std::vector<StateCheckpoint> saved_states_stack_{};
         std::vector<SaveRestoreCallbackType> pre_save_hooks_{};
@@ -173,10 +199,18 @@ namespace transmission_nets::core::abstract {
             this->underlying().notify_save_state(savedStateId);
 
             // fmt::print("Saving state for {} with id {}\n", checkpointable_type, savedStateId);
-            // saved_states_stack_.emplace_back(std::move(this->underlying().value()), savedStateId);
-            auto val = this->underlying().value();
-            auto tmp = StateCheckpoint(val, savedStateId);
-            saved_states_stack_.push_back(tmp);
+            if constexpr (DefersCheckpoints<T>) {
+                assertUnchangedSinceCheckpoint();
+                saved_states_stack_.emplace_back(std::nullopt, savedStateId);
+#ifndef NDEBUG
+                if constexpr (std::equality_comparable<ValueType>) {
+                    saved_states_stack_.back().debug_state.emplace(this->underlying().value_);
+                }
+#endif
+            } else {
+                auto val = this->underlying().value();
+                saved_states_stack_.emplace_back(std::move(val), savedStateId);
+            }
             // fmt::print("Saved state for {} with id {}\n", checkpointable_type, savedStateId);
 
             for (auto& cb : post_save_hooks_) {
@@ -188,12 +222,16 @@ namespace transmission_nets::core::abstract {
     template<typename T, typename ValueType>
     void Checkpointable<T, ValueType>::restoreState(int savedStateId) noexcept {
         if (isSaved() and saved_states_stack_.back().saved_state_id == savedStateId) {
+            assertUnchangedSinceCheckpoint();
             for (auto& cb : pre_restore_hooks_) {
                 cb(savedStateId);
             }
 
             this->underlying().notify_restore_state(savedStateId);
-            this->underlying().value_ = std::move(saved_states_stack_.back().saved_state);
+            // A deferred checkpoint that is still empty means the value has not changed since it was saved
+            if (auto& savedState = saved_states_stack_.back().saved_state) {
+                this->underlying().value_ = std::move(*savedState);
+            }
             saved_states_stack_.pop_back();
 
             for (auto& cb : post_restore_hooks_) {
@@ -205,6 +243,7 @@ namespace transmission_nets::core::abstract {
     template<typename T, typename ValueType>
     void Checkpointable<T, ValueType>::acceptState() noexcept {
         if (isSaved()) {
+            assertUnchangedSinceCheckpoint();
             for (auto& cb : pre_accept_hooks_) {
                 cb();
             }
@@ -223,6 +262,27 @@ namespace transmission_nets::core::abstract {
         return !(this->saved_states_stack_.empty());
     }
 
+    template<typename T, typename ValueType>
+    void Checkpointable<T, ValueType>::checkpointBeforeChange() noexcept {
+        if constexpr (DefersCheckpoints<T>) {
+            if (isSaved() and !saved_states_stack_.back().saved_state) {
+                saved_states_stack_.back().saved_state.emplace(this->underlying().value_);
+            }
+        }
+    }
+
+    template<typename T, typename ValueType>
+    void Checkpointable<T, ValueType>::assertUnchangedSinceCheckpoint() noexcept {
+#ifndef NDEBUG
+        if constexpr (DefersCheckpoints<T> and std::equality_comparable<ValueType>) {
+            if (isSaved() and !saved_states_stack_.back().saved_state) {
+                // value_ changed without checkpointBeforeChange, restoring this checkpoint would keep the changed value
+                assert(saved_states_stack_.back().debug_state == this->underlying().value_);
+            }
+        }
+#endif
+    }
+
 }// namespace transmission_nets::core::abstract
 
 
@@ -0,0 +1,124 @@
+#ifndef TRANSMISSION_NETWORKS_APP_INLINECALLBACK_H
+#define TRANSMISSION_NETWORKS_APP_INLINECALLBACK_H
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace transmission_nets::core::abstract {
+
+    template<typename Signature, std::size_t Capacity = 6 * sizeof(void*)>
+    class InlineCallback;
+
+    /*
+     * Type erased callable with small buffer storage. Listener lambdas typically capture `this` and a shared pointer or two,
+     * which fit in the inline buffer, so registering and invoking them never touches the heap. Larger callables fall back to
+     * a heap allocation.
+     */
+    template<typename R, typename... Args, std::size_t Capacity>
+    class InlineCallback<R(Args...), Capacity> {
+        struct Ops {
+            R (*invoke)(void* storage, Args&&... args);
+            void (*copy)(void* dst, const void* src);
+            void (*move)(void* dst, void* src) noexcept;
+            void (*destroy)(void* storage) noexcept;
+        };
+
+        template<typename F>
+        static constexpr bool storedInline = sizeof(F) <= Capacity and alignof(F) <= alignof(std::max_align_t) and std::is_nothrow_move_constructible_v<F>;
+
+        template<typename F>
+        static constexpr Ops inlineOps{
+                [](void* storage, Args&&... args) -> R { return std::invoke(*static_cast<F*>(storage), std::forward<Args>(args)...); },
+                [](void* dst, const void* src) { ::new (dst) F(*static_cast<const F*>(src)); },
+                [](void* dst, void* src) noexcept {
+                    ::new (dst) F(std::move(*static_cast<F*>(src)));
+                    static_cast<F*>(src)->~F();
+                },
+                [](void* storage) noexcept { static_cast<F*>(storage)->~F(); }};
+
+        template<typename F>
+        static constexpr Ops heapOps{
+                [](void* storage, Args&&... args) -> R { return std::invoke(**static_cast<F**>(storage), std::forward<Args>(args)...); },
+                [](void* dst, const void* src) { ::new (dst) F*(new F(**static_cast<F* const*>(src))); },
+                [](void* dst, void* src) noexcept { ::new (dst) F*(*static_cast<F**>(src)); },
+                [](void* storage) noexcept { delete *static_cast<F**>(storage); }};
+
+    public:
+        InlineCallback() noexcept = default;
+
+        template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InlineCallback> and std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>>
+        InlineCallback(F&& f) {
+            using Fn = std::decay_t<F>;
+            if constexpr (storedInline<Fn>) {
+                ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(f));
+                ops_ = &inlineOps<Fn>;
+            } else {
+                ::new (static_cast<void*>(storage_)) Fn*(new Fn(std::forward<F>(f)));
+                ops_ = &heapOps<Fn>;
+            }
+        }
+
+        InlineCallback(const InlineCallback& other) : ops_(other.ops_) {
+            if (ops_) {
+                ops_->copy(storage_, other.storage_);
+            }
+        }
+
+        InlineCallback(InlineCallback&& other) noexcept : ops_(std::exchange(other.ops_, nullptr)) {
+            if (ops_) {
+                ops_->move(storage_, other.storage_);
+            }
+        }
+
+        InlineCallback& operator=(const InlineCallback& other) {
+            if (this != &other) {
+                InlineCallback tmp(other);
+                *this = std::move(tmp);
+            }
+            return *this;
+        }
+
+        InlineCallback& operator=(InlineCallback&& other) noexcept {
+            if (this != &other) {
+                reset();
+                ops_ = std::exchange(other.ops_, nullptr);
+                if (ops_) {
+                    ops_->move(storage_, other.storage_);
+                }
+            }
+            return *this;
+        }
+
+        ~InlineCallback() {
+            reset();
+        }
+
+        R operator()(Args... args) const {
+            return ops_->invoke(storage_, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const noexcept {
+            return ops_ != nullptr;
+        }
+
+    private:
+        void reset() noexcept {
+            if (ops_) {
+                ops_->destroy(storage_);
+                ops_ = nullptr;
+            }
+        }
+
+        // Invoking a listener may mutate its state, as with std::function
+        alignas(std::max_align_t) mutable std::byte storage_[Capacity]{};
+        const Ops* ops_ = nullptr;
+    };
+
+}// namespace transmission_nets::core::abstract
+
+
+#endif//TRANSMISSION_NETWORKS_APP_INLINECALLBACK_H
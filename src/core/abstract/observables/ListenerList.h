@@ -0,0 +1,139 @@
+#ifndef TRANSMISSION_NETWORKS_APP_LISTENERLIST_H
+#define TRANSMISSION_NETWORKS_APP_LISTENERLIST_H
+
+#include "core/abstract/observables/InlineCallback.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+
+namespace transmission_nets::core::abstract {
+
+    using ListenerId_t = uint_fast32_t;
+
+    /*
+     * Listeners of a single event, in registration order. Dispatch iterates the listeners in place. Listeners that are
+     * added while a dispatch is running are held aside and do not see the event being dispatched, and listeners that are
+     * removed while a dispatch is running are only marked, so the running dispatch skips them. Both are applied once the
+     * outermost dispatch has finished.
+     */
+    template<typename Signature>
+    class ListenerList {
+    public:
+        using Callback = InlineCallback<Signature>;
+
+        void add(ListenerId_t id, Callback callback);
+
+        /**
+         * @brief Remove the listener with the given id. Returns false if there is no such listener.
+         */
+        bool remove(ListenerId_t id);
+
+        template<typename... Args>
+        void dispatch(const Args&... args) const;
+
+        [[nodiscard]] std::size_t size() const noexcept {
+            return entries_.size() + added_.size() - removed_;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return size() == 0;
+        }
+
+    private:
+        struct Entry {
+            ListenerId_t id;
+            Callback callback;
+            bool removed = false;
+        };
+
+        void applyPending() const;
+
+        // Ids are handed out in increasing order, so entries_ stays sorted by id
+        mutable std::vector<Entry> entries_{};
+        mutable std::vector<Entry> added_{};
+        mutable std::size_t removed_ = 0;
+        mutable int dispatchDepth_   = 0;
+    };
+
+    template<typename Signature>
+    void ListenerList<Signature>::add(const ListenerId_t id, Callback callback) {
+        if (dispatchDepth_ > 0) {
+            added_.push_back({id, std::move(callback)});
+        } else {
+            entries_.push_back({id, std::move(callback)});
+        }
+    }
+
+    template<typename Signature>
+    bool ListenerList<Signature>::remove(const ListenerId_t id) {
+        const auto byId = [](const Entry& entry, const ListenerId_t id) { return entry.id < id; };
+
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), id, byId);
+        if (it != entries_.end() and it->id == id and !it->removed) {
+            if (dispatchDepth_ > 0) {
+                it->removed = true;
+                removed_++;
+            } else {
+                entries_.erase(it);
+            }
+            return true;
+        }
+
+        auto added = std::lower_bound(added_.begin(), added_.end(), id, byId);
+        if (added != added_.end() and added->id == id) {
+            added_.erase(added);
+            return true;
+        }
+        return false;
+    }
+
+    template<typename Signature>
+    template<typename... Args>
+    void ListenerList<Signature>::dispatch(const Args&... args) const {
+        // Listeners added during the dispatch are not visited, so the entries do not move while they are invoked
+        dispatchDepth_++;
+        const std::size_t total = entries_.size();
+        for (std::size_t i = 0; i < total; ++i) {
+            const auto& entry = entries_[i];
+            if (!entry.removed) {
+                entry.callback(args...);
+            }
+        }
+        dispatchDepth_--;
+
+        if (dispatchDepth_ == 0 and (removed_ > 0 or !added_.empty())) {
+            applyPending();
+        }
+    }
+
+    template<typename Signature>
+    void ListenerList<Signature>::applyPending() const {
+        if (removed_ > 0) {
+            std::erase_if(entries_, [](const Entry& entry) { return entry.removed; });
+            removed_ = 0;
+        }
+        for (auto& entry : added_) {
+            entries_.push_back(std::move(entry));
+        }
+        added_.clear();
+    }
+
+    template<typename Callback>
+    struct CallbackSignature;
+
+    template<typename Signature>
+    struct CallbackSignature<std::function<Signature>> {
+        using type = Signature;
+    };
+
+    // Listener storage for the std::function type an event is declared with
+    template<typename Callback>
+    using ListenersOf = ListenerList<typename CallbackSignature<Callback>::type>;
+
+}// namespace transmission_nets::core::abstract
+
+
+#endif//TRANSMISSION_NETWORKS_APP_LISTENERLIST_H
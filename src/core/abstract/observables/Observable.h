@@ -6,96 +6,112 @@
 #define TRANSMISSION_NETWORKS_APP_OBSERVABLE_H
 
 #include <boost/container/flat_map.hpp>
+#include <cassert>
 #include <iostream>
+#include <memory>
+#include <utility>
 
 #include <fmt/core.h>
 
 #include "core/abstract/crtp.h"
+#include "core/abstract/observables/ListenerList.h"
 
 //// Enables add and removing of callbacks for a given callback_type
 
-#define CREATE_EVENT(callback_name, callback_type)                                                      \
-public:                                                                                                 \
-    template<typename... Args>                                                                          \
-    void notify_##callback_name(Args... args) const noexcept {                                          \
-        this->notify(this->callback_name##_callbacks_, args...);                                        \
-    }                                                                                                   \
-                                                                                                        \
-    auto add_##callback_name##_listener(const callback_type& cb) noexcept->core::abstract::ListenerId { \
-        return this->add_listener(cb, this->callback_name##_callbacks_);                                \
-    }                                                                                                   \
-                                                                                                        \
-    auto remove_##callback_name##_listener(const core::abstract::ListenerId_t id) noexcept->bool {      \
-        return this->remove_listener(id, this->callback_name##_callbacks_);                             \
-    }                                                                                                   \
-                                                                                                        \
-private:                                                                                                \
-    core::abstract::ObserverMap<core::abstract::ListenerId_t, callback_type> callback_name##_callbacks_{};
+#define CREATE_EVENT(callback_name, callback_type)                                                  \
+public:                                                                                             \
+    template<typename... Args>                                                                      \
+    void notify_##callback_name(const Args&... args) const noexcept {                               \
+        this->notify(this->callback_name##_callbacks_, args...);                                    \
+    }                                                                                               \
+                                                                                                    \
+    template<typename Callback>                                                                     \
+    auto add_##callback_name##_listener(Callback&& cb) noexcept->core::abstract::ListenerId {       \
+        return this->add_listener(std::forward<Callback>(cb), this->callback_name##_callbacks_);    \
+    }                                                                                               \
+                                                                                                    \
+    auto remove_##callback_name##_listener(const core::abstract::ListenerId_t id) noexcept->bool {  \
+        return this->remove_listener(id, this->callback_name##_callbacks_);                         \
+    }                                                                                               \
+                                                                                                    \
+private:                                                                                            \
+    core::abstract::ListenersOf<callback_type> callback_name##_callbacks_{};
 
 //// Enables adding and removing of callbacks that are keyed (i.e. callbacks that depend on specific elements can be registered)
-#define CREATE_KEYED_EVENT(callback_name, KeyType, CallbackType)                                                                          \
-public:                                                                                                                                   \
-    template<typename... Args>                                                                                                            \
-    void keyed_notify_##callback_name(KeyType key, Args... args) const noexcept {                                                         \
-        this->keyed_notify(key, this->keyed_##callback_name##_callbacks_, args...);                                                       \
-    }                                                                                                                                     \
-                                                                                                                                          \
-    auto add_keyed_##callback_name##_listener(KeyType key, const CallbackType& cb) noexcept->core::abstract::ListenerId {                 \
-        return this->add_keyed_listener(key, cb, this->keyed_##callback_name##_callbacks_);                                               \
-    }                                                                                                                                     \
-                                                                                                                                          \
-    auto remove_keyed_##callback_name##_listener(KeyType key, const core::abstract::ListenerId_t id) noexcept->bool {                     \
-        return this->remove_keyed_listener(key, id, this->keyed_##callback_name##_callbacks_);                                            \
-    }                                                                                                                                     \
-                                                                                                                                          \
-    void register_##callback_name##_listener_key(KeyType key) noexcept {                                                                  \
-        this->keyed_##callback_name##_callbacks_.emplace(key, core::abstract::ObserverMap<core::abstract::ListenerId_t, CallbackType>{}); \
-    }                                                                                                                                     \
-                                                                                                                                          \
-private:                                                                                                                                  \
-    core::abstract::ObserverMap<KeyType, core::abstract::ObserverMap<core::abstract::ListenerId_t, CallbackType>> keyed_##callback_name##_callbacks_{};
-
-
-#define CRTP_CREATE_EVENT(callback_name, callback_type)                                                 \
-public:                                                                                                 \
-    template<typename... Args>                                                                          \
-    void notify_##callback_name(Args... args) const noexcept {                                          \
-        this->underlying().notify(this->callback_name##_callbacks_, args...);                           \
-    }                                                                                                   \
-                                                                                                        \
-    auto add_##callback_name##_listener(const callback_type& cb) noexcept->core::abstract::ListenerId { \
-        return this->underlying().add_listener(cb, this->callback_name##_callbacks_);                   \
-    }                                                                                                   \
-                                                                                                        \
-    auto remove_##callback_name##_listener(const core::abstract::ListenerId_t id) noexcept->bool {      \
-        return this->underlying().remove_listener(id, this->callback_name##_callbacks_);                \
-    }                                                                                                   \
-                                                                                                        \
-protected:                                                                                              \
-    core::abstract::ObserverMap<core::abstract::ListenerId_t, callback_type> callback_name##_callbacks_{};
-
-
-#define CRTP_CREATE_KEYED_EVENT(callback_name, KeyType, CallbackType)                                                                     \
-public:                                                                                                                                   \
-    template<typename... Args>                                                                                                            \
-    void keyed_notify_##callback_name(KeyType key, Args... args) const noexcept {                                                         \
-        this->underlying().keyed_notify(key, this->keyed_##callback_name##_callbacks_, args...);                                          \
-    }                                                                                                                                     \
-                                                                                                                                          \
-    auto add_keyed_##callback_name##_listener(KeyType key, const CallbackType& cb) noexcept->core::abstract::ListenerId {                 \
-        return this->underlying().add_keyed_listener(key, cb, this->keyed_##callback_name##_callbacks_);                                  \
-    }                                                                                                                                     \
-                                                                                                                                          \
-    auto remove_keyed_##callback_name##_listener(KeyType key, const core::abstract::ListenerId_t id) noexcept->bool {                     \
-        return this->underlying().remove_keyed_listener(key, id, this->keyed_##callback_name##_callbacks_);                               \
-    }                                                                                                                                     \
-                                                                                                                                          \
-    void register_##callback_name##_listener_key(KeyType key) noexcept {                                                                  \
-        this->keyed_##callback_name##_callbacks_.emplace(key, core::abstract::ObserverMap<core::abstract::ListenerId_t, CallbackType>{}); \
-    }                                                                                                                                     \
-                                                                                                                                          \
-private:                                                                                                                                  \
-    core::abstract::ObserverMap<KeyType, core::abstract::ObserverMap<core::abstract::ListenerId_t, CallbackType>> keyed_##callback_name##_callbacks_{};
+#define CREATE_KEYED_EVENT(callback_name, KeyType, CallbackType)                                                                  \
+public:                                                                                                                           \
+    template<typename... Args>                                                                                                    \
+    void keyed_notify_##callback_name(const KeyType& key, const Args&... args) const noexcept {                                   \
+        this->keyed_notify(key, this->keyed_##callback_name##_callbacks_, args...);                                               \
+    }                                                                                                                             \
+                                                                                                                                  \
+    template<typename Callback>                                                                                                   \
+    auto add_keyed_##callback_name##_listener(const KeyType& key, Callback&& cb) noexcept->core::abstract::ListenerId {           \
+        return this->add_keyed_listener(key, std::forward<Callback>(cb), this->keyed_##callback_name##_callbacks_);               \
+    }                                                                                                                             \
+                                                                                                                                  \
+    auto remove_keyed_##callback_name##_listener(const KeyType& key, const core::abstract::ListenerId_t id) noexcept->bool {      \
+        return this->remove_keyed_listener(key, id, this->keyed_##callback_name##_callbacks_);                                    \
+    }                                                                                                                             \
+                                                                                                                                  \
+    void register_##callback_name##_listener_key(const KeyType& key) noexcept {                                                   \
+        this->keyed_##callback_name##_callbacks_.try_emplace(key, std::make_unique<core::abstract::ListenersOf<CallbackType>>());  \
+    }                                                                                                                             \
+                                                                                                                                  \
+    [[nodiscard]] auto keyed_##callback_name##_listener_count(const KeyType& key) const noexcept->std::size_t {                   \
+        return this->keyed_##callback_name##_callbacks_.at(key)->size();                                                          \
+    }                                                                                                                             \
+                                                                                                                                  \
+private:                                                                                                                          \
+    core::abstract::KeyedListeners<KeyType, core::abstract::ListenersOf<CallbackType>> keyed_##callback_name##_callbacks_{};
+
+
+#define CRTP_CREATE_EVENT(callback_name, callback_type)                                                     \
+public:                                                                                                     \
+    template<typename... Args>                                                                              \
+    void notify_##callback_name(const Args&... args) const noexcept {                                       \
+        this->underlying().notify(this->callback_name##_callbacks_, args...);                               \
+    }                                                                                                       \
+                                                                                                            \
+    template<typename Callback>                                                                             \
+    auto add_##callback_name##_listener(Callback&& cb) noexcept->core::abstract::ListenerId {               \
+        return this->underlying().add_listener(std::forward<Callback>(cb), this->callback_name##_callbacks_); \
+    }                                                                                                       \
+                                                                                                            \
+    auto remove_##callback_name##_listener(const core::abstract::ListenerId_t id) noexcept->bool {          \
+        return this->underlying().remove_listener(id, this->callback_name##_callbacks_);                    \
+    }                                                                                                       \
+                                                                                                            \
+protected:                                                                                                  \
+    core::abstract::ListenersOf<callback_type> callback_name##_callbacks_{};
+
+
+#define CRTP_CREATE_KEYED_EVENT(callback_name, KeyType, CallbackType)                                                             \
+public:                                                                                                                           \
+    template<typename... Args>                                                                                                    \
+    void keyed_notify_##callback_name(const KeyType& key, const Args&... args) const noexcept {                                   \
+        this->underlying().keyed_notify(key, this->keyed_##callback_name##_callbacks_, args...);                                  \
+    }                                                                                                                             \
+                                                                                                                                  \
+    template<typename Callback>                                                                                                   \
+    auto add_keyed_##callback_name##_listener(const KeyType& key, Callback&& cb) noexcept->core::abstract::ListenerId {           \
+        return this->underlying().add_keyed_listener(key, std::forward<Callback>(cb), this->keyed_##callback_name##_callbacks_);  \
+    }                                                                                                                             \
+                                                                                                                                  \
+    auto remove_keyed_##callback_name##_listener(const KeyType& key, const core::abstract::ListenerId_t id) noexcept->bool {      \
+        return this->underlying().remove_keyed_listener(key, id, this->keyed_##callback_name##_callbacks_);                       \
+    }                                                                                                                             \
+                                                                                                                                  \
+    void register_##callback_name##_listener_key(const KeyType& key) noexcept {                                                   \
+        this->keyed_##callback_name##_callbacks_.try_emplace(key, std::make_unique<core::abstract::ListenersOf<CallbackType>>());  \
+    }                                                                                                                             \
+                                                                                                                                  \
+    [[nodiscard]] auto keyed_##callback_name##_listener_count(const KeyType& key) const noexcept->std::size_t {                   \
+        return this->keyed_##callback_name##_callbacks_.at(key)->size();                                                          \
+    }                                                                                                                             \
+                                                                                                                                  \
+private:                                                                                                                          \
+    core::abstract::KeyedListeners<KeyType, core::abstract::ListenersOf<CallbackType>> keyed_##callback_name##_callbacks_{};
 
 
 namespace transmission_nets::core::abstract {
@@ -103,7 +119,11 @@ namespace transmission_nets::core::abstract {
     template<typename Key, typename Value>
     using ObserverMap = boost::container::flat_map<Key, Value>;
 
-    using ListenerId_t = uint_fast32_t;
+    // Keys may be registered while a keyed dispatch is running, so each listener list is held by pointer and stays put
+    // when the map grows
+    template<typename Key, typename Listeners>
+    using KeyedListeners = ObserverMap<Key, std::unique_ptr<Listeners>>;
+
     enum ListenerId : ListenerId_t {};
 
     template<typename T>
@@ -111,27 +131,23 @@ namespace transmission_nets::core::abstract {
     public:
         static auto id_value() -> ListenerId_t&;
 
-        template<typename Callback>
-        auto
-        add_listener(const Callback& cb, ObserverMap<ListenerId_t, Callback>& callback_container) noexcept -> ListenerId;
+        template<typename Callback, typename Listeners>
+        auto add_listener(Callback&& cb, Listeners& listeners) noexcept -> ListenerId;
 
-        template<typename Callback>
-        auto remove_listener(ListenerId_t id, ObserverMap<ListenerId_t, Callback>& callback_container) noexcept -> bool;
+        template<typename Listeners>
+        auto remove_listener(ListenerId_t id, Listeners& listeners) noexcept -> bool;
 
-        template<typename Callback, typename... Args>
-        void notify(const ObserverMap<ListenerId_t, Callback>& callback_container, Args... args) const noexcept;
+        template<typename Listeners, typename... Args>
+        void notify(const Listeners& listeners, const Args&... args) const noexcept;
 
-        template<typename KeyType, typename Callback>
-        auto add_keyed_listener(KeyType key, const Callback& cb,
-                                ObserverMap<KeyType, ObserverMap<ListenerId_t, Callback>>& callback_container) noexcept -> ListenerId;
+        template<typename KeyType, typename Callback, typename Listeners>
+        auto add_keyed_listener(const KeyType& key, Callback&& cb, KeyedListeners<KeyType, Listeners>& listeners) noexcept -> ListenerId;
 
-        template<typename KeyType, typename Callback>
-        auto remove_keyed_listener(KeyType key, ListenerId_t id,
-                                   ObserverMap<KeyType, ObserverMap<ListenerId_t, Callback>>& callback_container) noexcept -> bool;
+        template<typename KeyType, typename Listeners>
+        auto remove_keyed_listener(const KeyType& key, ListenerId_t id, KeyedListeners<KeyType, Listeners>& listeners) noexcept -> bool;
 
-        template<typename KeyType, typename Callback, typename... Args>
-        void keyed_notify(KeyType key, const ObserverMap<KeyType, ObserverMap<ListenerId_t, Callback>>& callback_container,
-                          Args... args) const noexcept;
+        template<typename KeyType, typename Listeners, typename... Args>
+        void keyed_notify(const KeyType& key, const KeyedListeners<KeyType, Listeners>& listeners, const Args&... args) const noexcept;
     };
 
     template<typename T>
@@ -141,63 +157,51 @@ namespace transmission_nets::core::abstract {
     }
 
     template<typename T>
-    template<typename Callback>
-    auto Observable<T>::add_listener(const Callback& cb,
-                                     ObserverMap<ListenerId_t, Callback>& callback_container) noexcept -> ListenerId {
+    template<typename Callback, typename Listeners>
+    auto Observable<T>::add_listener(Callback&& cb, Listeners& listeners) noexcept -> ListenerId {
         const auto id = ListenerId(++id_value());
-        callback_container.emplace(id, cb);
+        listeners.add(id, std::forward<Callback>(cb));
         return id;
     }
 
     template<typename T>
-    template<typename Callback>
-    auto Observable<T>::remove_listener(const ListenerId_t id,
-                                        ObserverMap<ListenerId_t, Callback>& callback_container) noexcept -> bool {
-        auto elements_removed = callback_container.erase(id);
-        if (elements_removed != 1) {
-            fmt::print("{} Elements Removed.", elements_removed);
-            assert(elements_removed == 1);
+    template<typename Listeners>
+    auto Observable<T>::remove_listener(const ListenerId_t id, Listeners& listeners) noexcept -> bool {
+        const bool removed = listeners.remove(id);
+        if (!removed) {
+            fmt::print("0 Elements Removed.");
+            assert(removed);
             exit(1);
         }
-        return elements_removed > 0;
+        return removed;
     }
 
     template<typename T>
-    template<typename Callback, typename... Args>
-    void Observable<T>::notify(const ObserverMap<ListenerId_t, Callback>& callback_container, Args... args) const noexcept {
-        for (const auto& pair : callback_container) {
-            pair.second(args...);
-        }
+    template<typename Listeners, typename... Args>
+    void Observable<T>::notify(const Listeners& listeners, const Args&... args) const noexcept {
+        listeners.dispatch(args...);
     }
 
     template<typename T>
-    template<typename KeyType, typename Callback>
-    auto Observable<T>::add_keyed_listener(KeyType key, const Callback& cb,
-                                           ObserverMap<KeyType, ObserverMap<ListenerId_t, Callback>>& callback_container) noexcept -> ListenerId {
+    template<typename KeyType, typename Callback, typename Listeners>
+    auto Observable<T>::add_keyed_listener(const KeyType& key, Callback&& cb, KeyedListeners<KeyType, Listeners>& listeners) noexcept -> ListenerId {
         const auto id = ListenerId(++id_value());
-        callback_container.at(key).emplace(id, cb);
+        listeners.at(key)->add(id, std::forward<Callback>(cb));
         return id;
     }
 
     template<typename T>
-    template<typename KeyType, typename Callback>
-    auto Observable<T>::remove_keyed_listener(KeyType key, const ListenerId_t id,
-                                              ObserverMap<KeyType, ObserverMap<ListenerId_t, Callback>>& callback_container) noexcept -> bool {
-        auto cbs              = callback_container.at(key);
-        auto elements_removed = cbs.erase(id);
-        assert(elements_removed == 1);
-        return elements_removed > 0;
+    template<typename KeyType, typename Listeners>
+    auto Observable<T>::remove_keyed_listener(const KeyType& key, const ListenerId_t id, KeyedListeners<KeyType, Listeners>& listeners) noexcept -> bool {
+        const bool removed = listeners.at(key)->remove(id);
+        assert(removed);
+        return removed;
     }
 
     template<typename T>
-    template<typename KeyType, typename Callback, typename... Args>
-    void Observable<T>::keyed_notify(KeyType key,
-                                     const ObserverMap<KeyType, ObserverMap<ListenerId_t, Callback>>& callback_container,
-                                     Args... args) const noexcept {
-        auto cbs = callback_container.at(key);
-        for (const auto& pair : cbs) {
-            pair.second(args...);
-        }
+    template<typename KeyType, typename Listeners, typename... Args>
+    void Observable<T>::keyed_notify(const KeyType& key, const KeyedListeners<KeyType, Listeners>& listeners, const Args&... args) const noexcept {
+        listeners.at(key)->dispatch(args...);
     }
 }// namespace transmission_nets::core::abstract
 
@@ -21,6 +21,12 @@ namespace transmission_nets::core::abstract {
     public:
         void setValue(ValueType value) noexcept;
 
+        /**
+         * @brief Change a saved value without notifying listeners. The caller notifies pre_change before the first staged
+         * change and post_change after the last, as parameters::Transaction does.
+         */
+        void stageValue(const ValueType& value) noexcept;
+
         void initializeValue(const ValueType& value) noexcept;
         void initializeValue(ValueType&& value) noexcept;
 
@@ -31,17 +37,27 @@ namespace transmission_nets::core::abstract {
     void Uncacheable<T, ValueType>::setValue(ValueType const value) noexcept {
         assert(this->underlying().isSaved());
         this->underlying().notify_pre_change();
+        this->underlying().checkpointBeforeChange();
         this->underlying().value_ = value;
         this->underlying().notify_post_change();
     }
 
+    template<typename T, typename ValueType>
+    void Uncacheable<T, ValueType>::stageValue(const ValueType& value) noexcept {
+        assert(this->underlying().isSaved());
+        this->underlying().checkpointBeforeChange();
+        this->underlying().value_ = value;
+    }
+
     template<typename T, typename ValueType>
     void Uncacheable<T, ValueType>::initializeValue(const ValueType& value) noexcept {
+        this->underlying().checkpointBeforeChange();
         this->underlying().value_ = value;
     }
 
     template<typename T, typename ValueType>
     void Uncacheable<T, ValueType>::initializeValue(ValueType&& value) noexcept {
+        this->underlying().checkpointBeforeChange();
         this->underlying().value_ = std::move(value);
     }
 
@@ -15,13 +15,28 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 
 namespace transmission_nets::core::computation {
 
+    /*
+     * Sum of the values of its targets, updated by the targets that changed since it was last evaluated. Each target has
+     * a dirty bit, so marking a target dirty is O(1) however many targets a change reaches. Floating point totals are
+     * kept with Neumaier compensated summation, so the subtract and add updates do not drift over a long run.
+     *
+     * Large dirty sets may be evaluated concurrently with OpenMP. The contributions are still added to the total one at a
+     * time in the order the targets became dirty, so the total is the same for any number of threads.
+     */
     template<typename Input, typename Output>
     class Accumulator : public Computation<Output>,
                         public abstract::Observable<Accumulator<Input, Output>>,
@@ -38,6 +53,14 @@ namespace transmission_nets::core::computation {
         void postRestoreState(int savedStateId);
 
         Output value() noexcept override;
+        Output peek() noexcept override;
+
+        /**
+         * @brief Evaluate dirty sets of at least `threshold` targets on `numThreads` threads, a threshold of 0 evaluates
+         * serially. Targets must not share lazily computed state, or `prepare` must bring it up to date, it is called
+         * before each concurrent evaluation.
+         */
+        void setParallelEvaluation(std::size_t threshold, int numThreads, std::function<void()> prepare = {});
 
         [[nodiscard]] int getNumTargets() const;
 
@@ -46,11 +69,28 @@ namespace transmission_nets::core::computation {
 
         friend class abstract::Checkpointable<Accumulator, Output>;
 
+        static constexpr bool compensated = std::is_floating_point_v<Output>;
+
+        void addToTotal(const Output& x) noexcept;
+        void subtractFromTotal(const Output& x) noexcept;
+        void markDirty(std::size_t idx);
+        bool evaluateDirtyTargets() noexcept;
+
         // using TargetSet = boost::container::flat_set<std::shared_ptr<Input>>;
         using TargetSet = std::vector<std::shared_ptr<Input>>;
 
         TargetSet targets_{};
-        TargetSet dirtyTargets_{};
+        // Indices of the dirty targets, in the order they became dirty, and a dirty bit per target
+        std::vector<std::size_t> dirtyTargets_{};
+        std::vector<std::uint8_t> isTargetDirty_{};
+        // Low order bits lost by the additions to value_, the total is value_ + compensation_
+        Output compensation_{};
+
+        std::size_t parallelThreshold_ = 0;
+        int parallelThreads_           = 1;
+        std::function<void()> prepareParallel_{};
+        // Values of the dirty targets when they were evaluated concurrently, in the order of dirtyTargets_
+        std::vector<Output> contributions_{};
 
         // std::vector<TargetSet> targetsCache_{};
         // std::vector<TargetSet> dirtyTargetsCache_{};
@@ -60,21 +100,16 @@ namespace transmission_nets::core::computation {
     template<typename Input, typename Output>
     void Accumulator<Input, Output>::addTarget(const std::shared_ptr<Input>& target) {
         this->setDirty();
+        const std::size_t idx = targets_.size();
         targets_.emplace_back(target);
-        dirtyTargets_.emplace_back(target);
+        isTargetDirty_.push_back(0);
+        markDirty(idx);
 
         target->add_set_dirty_listener([=, this]() {
-            bool alreadyDirty = false;
-            for (auto& el : dirtyTargets_) {
-                if (el == target) {
-                    alreadyDirty = true;
-                    break;
-                }
-            }
-            if (!alreadyDirty) {
-                dirtyTargets_.emplace_back(target);
+            if (!isTargetDirty_[idx]) {
+                markDirty(idx);
                 this->setDirty();
-                this->value_ -= target->peek();
+                subtractFromTotal(targets_[idx]->peek());
             }
         });
         target->registerCacheableCheckpointTarget(this);
@@ -85,49 +120,116 @@ namespace transmission_nets::core::computation {
     inline void Accumulator<PartialLikelihood, Likelihood>::addTarget(const std::shared_ptr<PartialLikelihood>& target) {
         this->setDirty();
 
-        //check if target is already in targets_
-        bool inserted = false;
-        for (auto& el : targets_) {
-            if (el == target) {
-                inserted = true;
-                break;
-            }
-        }
-#ifndef DNDEBUG
-        if (inserted) assert(!"Target added more than once. Check model specification.");
+#ifndef NDEBUG
+        if (std::find(targets_.begin(), targets_.end(), target) != targets_.end()) assert(!"Target added more than once. Check model specification.");
 #endif
+        const std::size_t idx = targets_.size();
         targets_.emplace_back(target);
-        dirtyTargets_.emplace_back(target);
+        isTargetDirty_.push_back(0);
+        target->registerCacheableCheckpointTarget(this);
+        markDirty(idx);
 
         target->add_set_dirty_listener([=, this]() {
-            bool alreadyDirty = false;
-            for (auto& el : dirtyTargets_) {
-                if (el == target) {
-                    alreadyDirty = true;
-                    break;
-                }
-            }
-
-            if (!alreadyDirty) {
-                dirtyTargets_.emplace_back(target);
+            if (!isTargetDirty_[idx]) {
+                markDirty(idx);
                 this->setDirty();
-                this->value_ -= target->peek();
+                subtractFromTotal(targets_[idx]->peek());
             }
         });
-
-        target->registerCacheableCheckpointTarget(this);
     }
 
 
     template<typename Input, typename Output>
     Output Accumulator<Input, Output>::value() noexcept {
-        for (auto el : dirtyTargets_) {
-            this->value_ += el->value();
+        const bool evaluated = evaluateDirtyTargets();
+        for (std::size_t k = 0; k < dirtyTargets_.size(); ++k) {
+            const auto idx = dirtyTargets_[k];
+            addToTotal(evaluated ? contributions_[k] : targets_[idx]->value());
+            isTargetDirty_[idx] = 0;
         }
         this->setClean();
         dirtyTargets_.resize(0);
 
-        return this->value_;
+        return peek();
+    }
+
+
+    template<typename Input, typename Output>
+    Output Accumulator<Input, Output>::peek() noexcept {
+        if constexpr (compensated) {
+            return this->value_ + compensation_;
+        } else {
+            return this->value_;
+        }
+    }
+
+
+    template<typename Input, typename Output>
+    void Accumulator<Input, Output>::addToTotal(const Output& x) noexcept {
+        if constexpr (compensated) {
+            const Output total = this->value_ + x;
+            // Once the total is infinite it stays so until restored, and has nothing to compensate
+            if (std::isfinite(total)) {
+                if (std::abs(this->value_) >= std::abs(x)) {
+                    compensation_ += (this->value_ - total) + x;
+                } else {
+                    compensation_ += (x - total) + this->value_;
+                }
+            } else {
+                compensation_ = 0;
+            }
+            this->value_ = total;
+        } else {
+            this->value_ += x;
+        }
+    }
+
+
+    template<typename Input, typename Output>
+    void Accumulator<Input, Output>::subtractFromTotal(const Output& x) noexcept {
+        if constexpr (compensated) {
+            addToTotal(-x);
+        } else {
+            this->value_ -= x;
+        }
+    }
+
+
+    template<typename Input, typename Output>
+    void Accumulator<Input, Output>::markDirty(const std::size_t idx) {
+        isTargetDirty_[idx] = 1;
+        dirtyTargets_.push_back(idx);
+    }
+
+
+    template<typename Input, typename Output>
+    void Accumulator<Input, Output>::setParallelEvaluation(const std::size_t threshold, const int numThreads, std::function<void()> prepare) {
+        parallelThreshold_ = threshold;
+        parallelThreads_   = std::max(numThreads, 1);
+        prepareParallel_   = std::move(prepare);
+    }
+
+
+    /*
+     * Evaluates the dirty targets into contributions_ if there are enough of them to be worth spreading over threads,
+     * returns false if they are left to be evaluated serially.
+     */
+    template<typename Input, typename Output>
+    bool Accumulator<Input, Output>::evaluateDirtyTargets() noexcept {
+        if (parallelThreshold_ == 0 or parallelThreads_ < 2 or dirtyTargets_.size() < parallelThreshold_) {
+            return false;
+        }
+        if (prepareParallel_) {
+            prepareParallel_();
+        }
+
+        contributions_.resize(dirtyTargets_.size());
+        const auto totalDirty = static_cast<std::ptrdiff_t>(dirtyTargets_.size());
+#pragma omp parallel for default(none) shared(totalDirty) num_threads(parallelThreads_) schedule(dynamic)
+        for (std::ptrdiff_t k = 0; k < totalDirty; ++k) {
+            contributions_[k] = targets_[dirtyTargets_[k]]->value();
+        }
+        return true;
     }
 
 
@@ -142,6 +244,8 @@ namespace transmission_nets::core::computation {
 
     template<typename Input, typename Output>
     void Accumulator<Input, Output>::postRestoreState([[maybe_unused]] int savedStateId) {
+        // The restored total was saved with its compensation folded in
+        compensation_ = Output{};
         // targets_      = targetsCache_.back();
         // dirtyTargets_ = dirtyTargetsCache_.back();
 
@@ -161,20 +265,25 @@ namespace transmission_nets::core::computation {
     inline Likelihood Accumulator<PartialLikelihood, Likelihood>::value() noexcept {
         assert(this->value_ < std::numeric_limits<Likelihood>::infinity());
 
-        for (auto& el : dirtyTargets_) {
+        const bool evaluated = evaluateDirtyTargets();
+        for (std::size_t k = 0; k < dirtyTargets_.size(); ++k) {
             assert(this->value_ < std::numeric_limits<Likelihood>::infinity());
 
-            if (std::isnan(el->value())) {
-                this->value_ = -std::numeric_limits<Likelihood>::infinity();
+            const auto idx                = dirtyTargets_[k];
+            const Likelihood contribution = evaluated ? contributions_[k] : targets_[idx]->value();
+            if (std::isnan(contribution)) {
+                this->value_  = -std::numeric_limits<Likelihood>::infinity();
+                compensation_ = 0;
             } else {
-                this->value_ += el->value();
+                addToTotal(contribution);
             }
+            isTargetDirty_[idx] = 0;
             assert(this->value_ < std::numeric_limits<Likelihood>::infinity());
         }
-        this->setClean();
         dirtyTargets_.clear();
+        this->setClean();
 
-        return this->value_;
+        return peek();
     }
 
 
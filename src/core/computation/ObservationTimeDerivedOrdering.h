@@ -14,7 +14,11 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <cassert>
+#include <limits>
 #include <memory>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -27,18 +31,35 @@ namespace transmission_nets::core::computation {
                                            public abstract::Cacheable<ObservationTimeDerivedOrdering<InfectionEventImpl>>,
                                            public abstract::Checkpointable<ObservationTimeDerivedOrdering<InfectionEventImpl>, std::vector<std::shared_ptr<InfectionEventImpl>>> {
         using MovedCallback = std::function<void(std::shared_ptr<InfectionEventImpl> element)>;
+        using MovedPastCallback = std::function<void(std::span<const std::shared_ptr<InfectionEventImpl>> elements)>;
         using ChangedCallback = std::function<void(std::shared_ptr<InfectionEventImpl> element)>;
-        CREATE_KEYED_EVENT(moved_left, std::shared_ptr<InfectionEventImpl>, MovedCallback);
-        CREATE_KEYED_EVENT(moved_right, std::shared_ptr<InfectionEventImpl>, MovedCallback);
-        CREATE_EVENT(element_changed, ChangedCallback);
+        CREATE_KEYED_EVENT(moved_left, std::shared_ptr<InfectionEventImpl>, MovedCallback); // Notifies that an element has been moved left of key
+        CREATE_KEYED_EVENT(moved_right, std::shared_ptr<InfectionEventImpl>, MovedCallback);// Notifies that an element has been moved right of key
+        CREATE_KEYED_EVENT(element_moved, std::shared_ptr<InfectionEventImpl>, MovedCallback);// Notifies listeners of key that it has moved, compare positions to find where
+        CREATE_KEYED_EVENT(moved_left_past, std::shared_ptr<InfectionEventImpl>, MovedPastCallback);// Notifies that key has been moved left of all elements
+        CREATE_KEYED_EVENT(moved_right_past, std::shared_ptr<InfectionEventImpl>, MovedPastCallback);// Notifies that key has been moved right of all elements
+        CREATE_KEYED_EVENT(element_changed, std::shared_ptr<InfectionEventImpl>, ChangedCallback);// Notifies listeners of key that it has changed
 
     public:
+        // Checkpoints copy the ordering only when an infection actually moves
+        static constexpr bool deferCheckpoints = true;
+
         explicit ObservationTimeDerivedOrdering() noexcept;
         explicit ObservationTimeDerivedOrdering(const std::vector<std::shared_ptr<InfectionEventImpl>>& refs) noexcept;
 
         void addElements(const std::vector<std::shared_ptr<InfectionEventImpl>>& refs) noexcept;
         std::vector<std::shared_ptr<InfectionEventImpl>> value() override;
 
+        /**
+         * @brief The current ordering without copying it. The view is invalidated when the ordering changes.
+         */
+        std::span<const std::shared_ptr<InfectionEventImpl>> view() noexcept;
+
+        /**
+         * @brief Index of the element in the ordering.
+         */
+        [[nodiscard]] std::size_t position(const std::shared_ptr<InfectionEventImpl>& ref) const noexcept;
+
     protected:
         friend class abstract::Cacheable<ObservationTimeDerivedOrdering<InfectionEventImpl>>;
         friend class abstract::Checkpointable<ObservationTimeDerivedOrdering<InfectionEventImpl>, std::vector<std::shared_ptr<InfectionEventImpl>>>;
@@ -47,14 +68,37 @@ namespace transmission_nets::core::computation {
         void infectionDurationChanged(std::shared_ptr<InfectionEventImpl> ref);
         void elementChanged(std::shared_ptr<InfectionEventImpl> ref);
         void addElement(std::shared_ptr<InfectionEventImpl> ref) noexcept;
+        void reindex(std::size_t first, std::size_t last) noexcept;
+        void recordMove(std::size_t first, std::size_t last) noexcept;
+
+        // Position of each element in value_, indexed by uid
+        std::vector<std::size_t> positions_{};
+        // Positions moved since the outermost open checkpoint, the only ones a restore can change
+        std::size_t movedFirst_ = 0;
+        std::size_t movedLast_  = 0;
+        bool restoresValue_     = false;
     };
 
     template<typename InfectionEventImpl>
     ObservationTimeDerivedOrdering<InfectionEventImpl>::ObservationTimeDerivedOrdering() noexcept : Computation<std::vector<std::shared_ptr<InfectionEventImpl>>>() {
+        this->addPostSaveHook([this]([[maybe_unused]] const int savedStateId) {
+            if (this->saved_states_stack_.size() == 1) {
+                movedFirst_ = movedLast_ = 0;
+            }
+        });
+        // An empty deferred checkpoint means nothing moved since it was saved, and the restore leaves value_ alone
+        this->addPreRestoreHook([this]([[maybe_unused]] const int savedStateId) {
+            restoresValue_ = this->saved_states_stack_.back().saved_state.has_value();
+        });
+        this->addPostRestoreHook([this]([[maybe_unused]] const int savedStateId) {
+            if (restoresValue_) {
+                reindex(movedFirst_, movedLast_);
+            }
+        });
     }
 
     template<typename InfectionEventImpl>
-    ObservationTimeDerivedOrdering<InfectionEventImpl>::ObservationTimeDerivedOrdering(const std::vector<std::shared_ptr<InfectionEventImpl>>& refs) noexcept {
+    ObservationTimeDerivedOrdering<InfectionEventImpl>::ObservationTimeDerivedOrdering(const std::vector<std::shared_ptr<InfectionEventImpl>>& refs) noexcept : ObservationTimeDerivedOrdering() {
         addElements(refs);
     }
 
@@ -63,7 +107,10 @@ namespace transmission_nets::core::computation {
         this->value_.push_back(ref);
         register_moved_left_listener_key(ref);
         register_moved_right_listener_key(ref);
-//        register_element_changed_listener_key(ref);
+        register_element_moved_listener_key(ref);
+        register_moved_left_past_listener_key(ref);
+        register_moved_right_past_listener_key(ref);
+        register_element_changed_listener_key(ref);
 
         ref->infectionDuration()->add_post_change_listener([=, this]() { this->infectionDurationChanged(ref); });
         ref->infectionDuration()->registerCacheableCheckpointTarget(this);
@@ -74,6 +121,7 @@ namespace transmission_nets::core::computation {
 
     template<typename InfectionEventImpl>
     void ObservationTimeDerivedOrdering<InfectionEventImpl>::addElements(const std::vector<std::shared_ptr<InfectionEventImpl>>& refs) noexcept {
+        this->checkpointBeforeChange();
         for (auto ref : refs) {
             addElement(std::move(ref));
         }
@@ -81,18 +129,44 @@ namespace transmission_nets::core::computation {
         std::sort(this->value_.begin(),
                   this->value_.end(),
                   [](std::shared_ptr<InfectionEventImpl> a, std::shared_ptr<InfectionEventImpl> b) { return a->infectionTime() < b->infectionTime(); });
+        reindex(0, this->value_.size());
 
         this->setDirty();
     }
 
     template<typename InfectionEventImpl>
-    void ObservationTimeDerivedOrdering<InfectionEventImpl>::infectionDurationChanged(std::shared_ptr<InfectionEventImpl> ref) {
-        double refInfectionTime = ref->infectionTime();
+    void ObservationTimeDerivedOrdering<InfectionEventImpl>::reindex(const std::size_t first, const std::size_t last) noexcept {
+        for (std::size_t idx = first; idx < last; ++idx) {
+            const auto uid = this->value_[idx]->uid();
+            if (positions_.size() <= uid) {
+                positions_.resize(uid + 1);
+            }
+            positions_[uid] = idx;
+        }
+    }
+
+    template<typename InfectionEventImpl>
+    void ObservationTimeDerivedOrdering<InfectionEventImpl>::recordMove(const std::size_t first, const std::size_t last) noexcept {
+        if (movedFirst_ == movedLast_) {
+            movedFirst_ = first;
+            movedLast_  = last;
+        } else {
+            movedFirst_ = std::min(movedFirst_, first);
+            movedLast_  = std::max(movedLast_, last);
+        }
+    }
 
-        // Find the index of the reference in the vector.
-        size_t refIdx = 0;
-        for (; this->value_[refIdx] != ref; ++refIdx)
-            ;
+    template<typename InfectionEventImpl>
+    std::size_t ObservationTimeDerivedOrdering<InfectionEventImpl>::position(const std::shared_ptr<InfectionEventImpl>& ref) const noexcept {
+        const std::size_t idx = positions_[ref->uid()];
+        assert(this->value_[idx] == ref);
+        return idx;
+    }
+
+    template<typename InfectionEventImpl>
+    void ObservationTimeDerivedOrdering<InfectionEventImpl>::infectionDurationChanged(std::shared_ptr<InfectionEventImpl> ref) {
+        const double refInfectionTime = ref->infectionTime();
+        const std::size_t refIdx      = position(ref);
 
         // Find the infection time of the infection just after the reference.
         // If the reference is the last element, then the infection time is a high number.
@@ -110,66 +184,62 @@ namespace transmission_nets::core::computation {
 
         // If the reference infection time is less than the left time or greater than the right time, then the reference is
         // out of order.
-        bool unsorted = refInfectionTime < leftTime or refInfectionTime > rightTime;
-
-        if (unsorted) {
-            this->setDirty();
-            // if the reference infection time is less than the left time, then the reference is moved to the left.
-            if (refInfectionTime < leftTime) {
-                while (unsorted) {
-                    // Make sure the reference is not the first element.
-                    if (refIdx > 0) {
-                        // Move the reference to the left.
-                        auto& curr = this->value_[refIdx];
-                        auto& prev = this->value_[refIdx - 1];
-                        std::swap(curr, prev);
-
-                        // Notify the listeners that the reference has moved to the left.
-                        keyed_notify_moved_left(this->value_[refIdx], this->value_[refIdx - 1]);
-                        keyed_notify_moved_right(this->value_[refIdx - 1], this->value_[refIdx]);
-
-                        // Update the reference index.
-                        --refIdx;
-
-                        // check if the reference is sorted.
-                        if (refIdx == 0 or this->value_[refIdx - 1]->infectionTime() < refInfectionTime) {
-                            unsorted = false;
-                        }
-                    } else {
-                        unsorted = false;
-                    }
+        if (refInfectionTime >= leftTime and refInfectionTime <= rightTime) {
+            return;
+        }
+        this->setDirty();
+
+        const auto begin = this->value_.begin();
+        if (refInfectionTime < leftTime) {
+            // The reference moves left past every element up to the first one that is earlier than it
+            std::size_t target = refIdx;
+            while (target > 0 and this->value_[target - 1]->infectionTime() >= refInfectionTime) {
+                --target;
+            }
+            if (target == refIdx) {
+                return;
+            }
+            this->checkpointBeforeChange();
+            std::rotate(begin + target, begin + refIdx, begin + refIdx + 1);
+            reindex(target, refIdx + 1);
+            recordMove(target, refIdx + 1);
+
+            const std::span<const std::shared_ptr<InfectionEventImpl>> passed(this->value_.data() + target + 1, refIdx - target);
+            // Listeners of either event see the same move, so dispatch whichever reaches fewer of them
+            if (keyed_element_moved_listener_count(ref) <= passed.size()) {
+                keyed_notify_element_moved(ref, ref);
+            } else {
+                for (const auto& el : passed) {
+                    keyed_notify_moved_left(el, ref);
                 }
+            }
+            keyed_notify_moved_left_past(ref, passed);
+        } else {
+            // The reference moves right past every element up to the first one that is later than it
+            std::size_t target = refIdx;
+            while (target + 1 < this->value_.size() and this->value_[target + 1]->infectionTime() <= refInfectionTime) {
+                ++target;
+            }
+            this->checkpointBeforeChange();
+            std::rotate(begin + refIdx, begin + refIdx + 1, begin + target + 1);
+            reindex(refIdx, target + 1);
+            recordMove(refIdx, target + 1);
+
+            const std::span<const std::shared_ptr<InfectionEventImpl>> passed(this->value_.data() + refIdx, target - refIdx);
+            if (keyed_element_moved_listener_count(ref) <= passed.size()) {
+                keyed_notify_element_moved(ref, ref);
             } else {
-                while (unsorted) {
-                    // Make sure the reference is not the last element.
-                    if (refIdx < this->value_.size() - 1) {
-                        // Move the reference to the right.
-                        auto& curr = this->value_[refIdx];
-                        auto& next = this->value_[refIdx + 1];
-                        std::swap(curr, next);
-
-                        // Notify the listeners that the reference has moved to the right.
-                        keyed_notify_moved_left(this->value_[refIdx + 1], this->value_[refIdx]);
-                        keyed_notify_moved_right(this->value_[refIdx], this->value_[refIdx + 1]);
-
-                        // Update the reference index.
-                        ++refIdx;
-
-                        // check if the reference is sorted.
-                        if (refIdx == this->value_.size() - 1 or this->value_[refIdx + 1]->infectionTime() > refInfectionTime) {
-                            unsorted = false;
-                        }
-                    } else {
-                        unsorted = false;
-                    }
+                for (const auto& el : passed) {
+                    keyed_notify_moved_right(el, ref);
                 }
             }
+            keyed_notify_moved_right_past(ref, passed);
         }
     }
 
     template<typename InfectionEventImpl>
     void ObservationTimeDerivedOrdering<InfectionEventImpl>::elementChanged(std::shared_ptr<InfectionEventImpl> ref) {
-        this->notify_element_changed(ref);
+        keyed_notify_element_changed(ref, ref);
         this->setDirty();
     }
 
@@ -179,6 +249,12 @@ namespace transmission_nets::core::computation {
         return this->value_;
     }
 
+    template<typename InfectionEventImpl>
+    std::span<const std::shared_ptr<InfectionEventImpl>> ObservationTimeDerivedOrdering<InfectionEventImpl>::view() noexcept {
+        this->setClean();
+        return this->value_;
+    }
+
 }// namespace transmission_nets::core::computation
 
 
@@ -12,11 +12,19 @@
 #include "core/containers/ParentSet.h"
 #include "core/parameters/Ordering.h"
 
+#include <concepts>
 #include <memory>
 #include <set>
 
 namespace transmission_nets::core::computation {
 
+    // Orderings that index their elements may instead notify the parent sets that allow the moved element, which compare
+    // positions themselves
+    template<typename OrderingImpl, typename ElementType>
+    concept IndexedOrdering = requires(OrderingImpl& ordering, const std::shared_ptr<ElementType>& element) {
+        { ordering.position(element) } -> std::convertible_to<std::size_t>;
+    };
+
     template<typename ElementType, typename OrderingImpl>
     class OrderDerivedParentSet : public Computation<containers::ParentSet<ElementType>>,
                                   public abstract::Observable<OrderDerivedParentSet<ElementType, OrderingImpl>>,
@@ -33,10 +41,20 @@ namespace transmission_nets::core::computation {
         CREATE_EVENT(element_changed, ElementChangedCallback)
 
     public:
+        // Most saves propagate from an ordering change that does not reach this child, so checkpoints copy the parent set
+        // only when it changes
+        static constexpr bool deferCheckpoints = true;
+
         explicit OrderDerivedParentSet(std::shared_ptr<OrderingImpl> ordering,
                                        std::shared_ptr<ElementType> child,
                                        const std::vector<std::shared_ptr<ElementType>>& allowedParents = {});
         containers::ParentSet<ElementType> value() noexcept override;
+
+        /**
+         * @brief The current parent set without copying it. The referenced set is updated in place as the ordering changes.
+         */
+        const containers::ParentSet<ElementType>& view() noexcept;
+
         void addAllowedParent(std::shared_ptr<ElementType> p);
         void addAllowedParents(const std::vector<std::shared_ptr<ElementType>>& p);
 
@@ -58,6 +76,7 @@ namespace transmission_nets::core::computation {
         ordering_->add_keyed_moved_left_listener(child_, [=, this](std::shared_ptr<ElementType> element) {
             if (allowedParents_.contains(element)) {
                 this->setDirty();
+                this->checkpointBeforeChange();
                 this->value_.insert(element);
                 this->notify_element_added(element);
             }
@@ -67,23 +86,40 @@ namespace transmission_nets::core::computation {
         ordering_->add_keyed_moved_right_listener(child_, [=, this](std::shared_ptr<ElementType> element) {
             if (allowedParents_.contains(element)) {
                 this->setDirty();
+                this->checkpointBeforeChange();
                 this->value_.erase(element);
                 this->notify_element_removed(element);
             }
         });
 
-        // If an element changes, trigger this event
-        ordering_->add_element_changed_listener([=, this](std::shared_ptr<ElementType> element) {
-            if (this->value_.contains(element)) {
-                this->setDirty();
-                this->notify_element_changed(element);
+        // If child_ moves left of a run of elements, those elements are no longer parents
+        ordering_->add_keyed_moved_left_past_listener(child_, [this](const auto& elements) {
+            for (const auto& element : elements) {
+                if (allowedParents_.contains(element)) {
+                    this->setDirty();
+                    this->checkpointBeforeChange();
+                    this->value_.erase(element);
+                    this->notify_element_removed(element);
+                }
+            }
+        });
+
+        // If child_ moves right of a run of elements, those elements are now parents
+        ordering_->add_keyed_moved_right_past_listener(child_, [this](const auto& elements) {
+            for (const auto& element : elements) {
+                if (allowedParents_.contains(element)) {
+                    this->setDirty();
+                    this->checkpointBeforeChange();
+                    this->value_.insert(element);
+                    this->notify_element_added(element);
+                }
             }
         });
 
         this->addAllowedParents(allowedParents);
 
         // Initialize the current parent set from the ordering
-        for (auto& el : ordering_->value()) {
+        for (const auto& el : ordering_->view()) {
             if (el != child_) {
                 if (allowedParents_.contains(el)) {
                     this->value_.insert(el);
@@ -97,8 +133,33 @@ namespace transmission_nets::core::computation {
 
     template<typename ElementType, typename OrderingImpl>
     void OrderDerivedParentSet<ElementType, OrderingImpl>::addAllowedParent(std::shared_ptr<ElementType> p) {
-        if (p != child_) {
-            allowedParents_.insert(p);
+        if (p != child_ and allowedParents_.insert(p).second) {
+            // Changes are routed by element, so only the parent sets that allow p as a parent are notified when it changes
+            ordering_->add_keyed_element_changed_listener(p, [this](std::shared_ptr<ElementType> element) {
+                if (this->value_.contains(element)) {
+                    this->setDirty();
+                    this->notify_element_changed(element);
+                }
+            });
+
+            if constexpr (IndexedOrdering<OrderingImpl, ElementType>) {
+                // p moved, so it is a parent exactly when it now precedes child_
+                ordering_->add_keyed_element_moved_listener(p, [this](std::shared_ptr<ElementType> element) {
+                    const bool precedes = ordering_->position(element) < ordering_->position(child_);
+                    if (precedes == this->value_.contains(element)) {
+                        return;
+                    }
+                    this->setDirty();
+                    this->checkpointBeforeChange();
+                    if (precedes) {
+                        this->value_.insert(element);
+                        this->notify_element_added(element);
+                    } else {
+                        this->value_.erase(element);
+                        this->notify_element_removed(element);
+                    }
+                });
+            }
         }
     }
 
@@ -113,11 +174,13 @@ namespace transmission_nets::core::computation {
     template<typename ElementType, typename OrderingImpl>
     containers::ParentSet<ElementType> OrderDerivedParentSet<ElementType, OrderingImpl>::value() noexcept {
         this->setClean();
-        containers::ParentSet<ElementType> out{};
-        for (auto el : this->value_) {
-            out.insert(el);
-        }
-        return out;
+        return this->value_;
+    }
+
+    template<typename ElementType, typename OrderingImpl>
+    const containers::ParentSet<ElementType>& OrderDerivedParentSet<ElementType, OrderingImpl>::view() noexcept {
+        this->setClean();
+        return this->value_;
     }
 
 }// namespace transmission_nets::core::computation
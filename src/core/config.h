@@ -6,7 +6,6 @@
 #define TRANSMISSION_NETWORKS_APP_CONFIG_H
 
 namespace transmission_nets::core::config {
-    const int MAX_CACHE_SIZE = 25;
 } // namespace transmission_nets::core::config
 
 #endif//TRANSMISSION_NETWORKS_APP_CONFIG_H
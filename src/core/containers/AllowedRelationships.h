@@ -5,67 +5,137 @@
 #ifndef ALLOWEDRELATIONSHIPS_H
 #define ALLOWEDRELATIONSHIPS_H
 
-// #include <map>
+#include <cassert>
+#include <cstddef>
 #include <memory>
-#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
-#include <fmt/format.h>
-
-#include <boost/container/flat_map.hpp>
-
 
 namespace transmission_nets::core::containers {
+
+    /*
+     * Immutable allowed parent/child relationships between infections, stored in compressed sparse row form for both
+     * directions. Infections are addressed by a dense index, their position in the vector the relationships are built
+     * from, and the neighbours of an infection are a contiguous run of the neighbour array, so lookups return spans
+     * without allocating or touching reference counts. Neighbours keep the order the relationships were declared in.
+     */
     template<typename InfectionEvent>
-    struct AllowedRelationships {
-        std::vector<std::shared_ptr<InfectionEvent>> allowedParents(const std::shared_ptr<InfectionEvent> infectionEvent) {
-            if (allowedParents_.find(infectionEvent) == allowedParents_.end()) {
-                return {};
-            }
-            std::vector<std::shared_ptr<InfectionEvent>> out;
-            for (const auto& parent : allowedParents_.at(infectionEvent)) {
-                out.push_back(infectionEvents_[parent]);
-            }
-            return out;
+    class AllowedRelationships {
+    public:
+        using Neighbours = std::span<const std::shared_ptr<InfectionEvent>>;
+        // (child index, parent index)
+        using Edge = std::pair<std::size_t, std::size_t>;
+
+        static constexpr std::size_t npos = ~std::size_t{0};
+
+        AllowedRelationships() = default;
+        AllowedRelationships(std::vector<std::shared_ptr<InfectionEvent>> infectionEvents, const std::vector<Edge>& edges);
+
+        [[nodiscard]] Neighbours allowedParents(const std::shared_ptr<InfectionEvent>& infectionEvent) const noexcept {
+            return allowedParents(index(infectionEvent));
         }
 
-        std::vector<std::shared_ptr<InfectionEvent>> allowedChildren(const std::shared_ptr<InfectionEvent> infectionEvent) {
-            if (allowedChildren_.find(infectionEvent) == allowedChildren_.end()) {
-                return {};
-            }
-            std::vector<std::shared_ptr<InfectionEvent>> out;
-            for (const auto& child : allowedChildren_.at(infectionEvent)) {
-                out.push_back(infectionEvents_[child]);
-            }
-            return out;
+        [[nodiscard]] Neighbours allowedChildren(const std::shared_ptr<InfectionEvent>& infectionEvent) const noexcept {
+            return allowedChildren(index(infectionEvent));
         }
 
-        void addParent(const std::shared_ptr<InfectionEvent> infectionEvent, const std::shared_ptr<InfectionEvent> parent) {
-            if (allowedParents_.find(infectionEvent) == allowedParents_.end()) {
-                allowedParents_.emplace(infectionEvent, std::vector<unsigned short>{});
-            }
-            allowedParents_.at(infectionEvent).push_back(parent->uid());
+        [[nodiscard]] Neighbours allowedParents(const std::size_t idx) const noexcept {
+            return parents_.neighbours(idx);
         }
 
-        void addChild(const std::shared_ptr<InfectionEvent> infectionEvent, const std::shared_ptr<InfectionEvent> child) {
-            if (allowedChildren_.find(infectionEvent) == allowedChildren_.end()) {
-                allowedChildren_.emplace(infectionEvent, std::vector<unsigned short>{});
-            }
-            allowedChildren_.at(infectionEvent).push_back(child->uid());
+        [[nodiscard]] Neighbours allowedChildren(const std::size_t idx) const noexcept {
+            return children_.neighbours(idx);
         }
 
-        void addInfectionEvent(const std::shared_ptr<InfectionEvent> infectionEvent) {
-            if (static_cast<unsigned short>(infectionEvents_.size()) < infectionEvent->uid() + 1) {
-                infectionEvents_.resize(infectionEvent->uid() + 1);
+        /**
+         * @brief Dense index of the infection, or npos if it is not part of the relationships.
+         */
+        [[nodiscard]] std::size_t index(const std::shared_ptr<InfectionEvent>& infectionEvent) const noexcept {
+            const auto uid = static_cast<std::size_t>(infectionEvent->uid());
+            if (uid >= indexByUid_.size()) {
+                return npos;
             }
-            infectionEvents_[infectionEvent->uid()] = infectionEvent;
+            const std::size_t idx = indexByUid_[uid];
+            // Uids are shared by every model in the process, so the uid alone does not identify an infection
+            return idx != npos and infectionEvents_[idx] == infectionEvent ? idx : npos;
+        }
+
+        [[nodiscard]] const std::shared_ptr<InfectionEvent>& infectionEvent(const std::size_t idx) const noexcept {
+            return infectionEvents_[idx];
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept {
+            return infectionEvents_.size();
         }
 
     private:
+        struct Adjacency {
+            // neighbours of infection i are targets[offsets[i], offsets[i + 1])
+            std::vector<std::size_t> offsets{};
+            std::vector<std::shared_ptr<InfectionEvent>> targets{};
+
+            [[nodiscard]] Neighbours neighbours(const std::size_t idx) const noexcept {
+                if (idx >= offsets.size() or idx + 1 == offsets.size()) {
+                    return {};
+                }
+                return Neighbours(targets).subspan(offsets[idx], offsets[idx + 1] - offsets[idx]);
+            }
+        };
+
+        static Adjacency buildAdjacency(const std::vector<std::shared_ptr<InfectionEvent>>& infectionEvents, const std::vector<Edge>& edges, bool byChild);
+
         std::vector<std::shared_ptr<InfectionEvent>> infectionEvents_{};
-        boost::container::flat_map<std::shared_ptr<InfectionEvent>, std::vector<unsigned short>> allowedParents_{};
-        boost::container::flat_map<std::shared_ptr<InfectionEvent>, std::vector<unsigned short>> allowedChildren_{};
+        std::vector<std::size_t> indexByUid_{};
+        Adjacency parents_{};
+        Adjacency children_{};
     };
+
+    template<typename InfectionEvent>
+    AllowedRelationships<InfectionEvent>::AllowedRelationships(std::vector<std::shared_ptr<InfectionEvent>> infectionEvents, const std::vector<Edge>& edges)
+        : infectionEvents_(std::move(infectionEvents)) {
+        for (std::size_t idx = 0; idx < infectionEvents_.size(); ++idx) {
+            const auto uid = static_cast<std::size_t>(infectionEvents_[idx]->uid());
+            if (indexByUid_.size() <= uid) {
+                indexByUid_.resize(uid + 1, npos);
+            }
+            assert(indexByUid_[uid] == npos);
+            indexByUid_[uid] = idx;
+        }
+
+        for (const auto& [child, parent] : edges) {
+            if (child >= infectionEvents_.size() or parent >= infectionEvents_.size()) {
+                throw std::out_of_range("Allowed relationship refers to an infection that is not part of the relationships");
+            }
+        }
+
+        parents_  = buildAdjacency(infectionEvents_, edges, true);
+        children_ = buildAdjacency(infectionEvents_, edges, false);
+    }
+
+    template<typename InfectionEvent>
+    auto AllowedRelationships<InfectionEvent>::buildAdjacency(const std::vector<std::shared_ptr<InfectionEvent>>& infectionEvents, const std::vector<Edge>& edges, const bool byChild) -> Adjacency {
+        // Counting sort of the edges by source, stable so neighbours stay in declaration order
+        Adjacency adjacency;
+        adjacency.offsets.assign(infectionEvents.size() + 1, 0);
+        for (const auto& [child, parent] : edges) {
+            assert(child < infectionEvents.size() and parent < infectionEvents.size());
+            adjacency.offsets[(byChild ? child : parent) + 1]++;
+        }
+        for (std::size_t idx = 0; idx < infectionEvents.size(); ++idx) {
+            adjacency.offsets[idx + 1] += adjacency.offsets[idx];
+        }
+
+        std::vector<std::size_t> next(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+        adjacency.targets.resize(edges.size());
+        for (const auto& [child, parent] : edges) {
+            const auto [source, target]       = byChild ? std::pair{child, parent} : std::pair{parent, child};
+            adjacency.targets[next[source]++] = infectionEvents[target];
+        }
+        return adjacency;
+    }
 }// namespace transmission_nets::core::containers
 
 
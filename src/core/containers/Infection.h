@@ -11,6 +11,7 @@
 #include "core/abstract/observables/UncacheablePassthrough.h"
 
 #include "core/containers/Locus.h"
+#include "core/containers/LocusMap.h"
 
 #include "core/datatypes/Data.h"
 
@@ -18,8 +19,12 @@
 
 #include <boost/container/flat_map.hpp>
 
+#include <cassert>
+#include <cstddef>
 #include <memory>
+#include <stdexcept>
 #include <utility>
+#include <vector>
 
 
 namespace transmission_nets::core::containers {
@@ -31,15 +36,13 @@ namespace transmission_nets::core::containers {
 
     public:
         template<typename Element>
-        using GenotypeMap          = boost::container::flat_map<std::shared_ptr<LocusImpl>, Element>;// Maps genetic readout to loci
+        using GenotypeMap          = LocusMap<LocusImpl, Element>;// Maps genetic readout to loci
         using GenotypeDataMap      = GenotypeMap<std::shared_ptr<datatypes::Data<GeneticImpl>>>;
         using GenotypeParameterMap = GenotypeMap<std::shared_ptr<parameters::Parameter<GeneticImpl>>>;
 
         explicit Infection(std::string id, double observationTime, bool symptomatic = true);
 
-        Infection(const Infection& other, const std::string& id = "", bool retain_alleles = true) {
-            static unsigned short uid = 0;
-            uid_ = uid++;
+        Infection(const Infection& other, const std::string& id = "", bool retain_alleles = true) : uid_(nextUid()) {
             // Copy constructor -- create a new infection from an existing one using the latent genetics.
             if (id.empty()) {
                 id_ = other.id_ + "_copy";
@@ -92,11 +95,11 @@ namespace transmission_nets::core::containers {
             return observedGenotype_;
         };
 
-        std::shared_ptr<datatypes::Data<GeneticImpl>> observedGenotype(std::shared_ptr<LocusImpl> locus) const {
+        std::shared_ptr<datatypes::Data<GeneticImpl>> observedGenotype(const std::shared_ptr<LocusImpl>& locus) const {
             return observedGenotype_.at(locus);
         };
 
-        std::shared_ptr<datatypes::Data<GeneticImpl>> observedGenotype(std::shared_ptr<LocusImpl> locus) {
+        std::shared_ptr<datatypes::Data<GeneticImpl>> observedGenotype(const std::shared_ptr<LocusImpl>& locus) {
             return observedGenotype_.at(locus);
         };
 
@@ -108,14 +111,31 @@ namespace transmission_nets::core::containers {
             return latentGenotype_;
         };
 
-        std::shared_ptr<parameters::Parameter<GeneticImpl>> latentGenotype(std::shared_ptr<LocusImpl> locus) {
+        std::shared_ptr<parameters::Parameter<GeneticImpl>> latentGenotype(const std::shared_ptr<LocusImpl>& locus) {
             return latentGenotype_.at(locus);
         };
 
-        std::shared_ptr<parameters::Parameter<GeneticImpl>> latentGenotype(std::shared_ptr<LocusImpl> locus) const {
+        std::shared_ptr<parameters::Parameter<GeneticImpl>> latentGenotype(const std::shared_ptr<LocusImpl>& locus) const {
             return latentGenotype_.at(locus);
         };
 
+        /**
+         * @brief Borrow the current latent genotype at a locus. Unlike latentGenotype(locus), no shared pointer is copied,
+         * so likelihood kernels can read genotypes without touching reference counts.
+         */
+        const GeneticImpl& latentGenotypeValue(const std::shared_ptr<LocusImpl>& locus) const {
+            assert(latentGenotype_.contains(locus));
+            return latentGenotypeValue(locus->index);
+        }
+
+        /**
+         * @brief Borrow the current latent genotype at the locus with the given index. The infection must have a latent
+         * genotype at the locus.
+         */
+        const GeneticImpl& latentGenotypeValue(const std::size_t locusIdx) const {
+            return latentGenotype_.atIndex(locusIdx)->value();
+        }
+
         /**
          * @brief Returns a vector of all the loci in the infection.
          * @return A vector of all the loci in the infection.
@@ -169,6 +189,14 @@ namespace transmission_nets::core::containers {
             return uid_;
         }
 
+        /**
+         * @brief Returns the locus whose latent genotype change is currently being notified through post_change.
+         * @return The changed locus while post_change listeners run, nullptr otherwise.
+         */
+        [[nodiscard]] const std::shared_ptr<LocusImpl>& changedLocus() const {
+            return changedLocus_;
+        }
+
         /**
          * @brief Returns the string representation of the infection using the id.
          * @return The string representation of the infection.
@@ -212,20 +240,33 @@ namespace transmission_nets::core::containers {
         }
 
     private:
+        // Infections and their copies draw uids from one counter, so a latent parent never shares a uid with an infection
+        static unsigned short nextUid() noexcept {
+            static unsigned short uid = 0;
+            return uid++;
+        }
+
+        void addLatentGenotype(const std::shared_ptr<LocusImpl>& locus, std::shared_ptr<parameters::Parameter<GeneticImpl>> lat);
+
+        void notifyLocusChanged(const std::shared_ptr<LocusImpl>& locus) {
+            changedLocus_ = locus;
+            this->notify_post_change();
+            changedLocus_ = nullptr;
+        }
+
         std::string id_;
-        int uid_;
+        unsigned short uid_;
         GenotypeMap<std::shared_ptr<datatypes::Data<GeneticImpl>>> observedGenotype_{};
         GenotypeMap<std::shared_ptr<parameters::Parameter<GeneticImpl>>> latentGenotype_{};
         std::vector<std::shared_ptr<LocusImpl>> loci_{};
+        std::shared_ptr<LocusImpl> changedLocus_{};
         std::shared_ptr<datatypes::Data<double>> observationTime_;
         std::shared_ptr<parameters::Parameter<double>> infectionDuration_;// default to 100 days? or maybe something else -- look in constructor
         std::shared_ptr<datatypes::Data<bool>> symptomatic_{};
     };
 
     template<typename GeneticImpl, typename LocusImpl>
-    Infection<GeneticImpl, LocusImpl>::Infection(std::string id, const double observationTime, const bool symptomatic) : id_(std::move(id)), observationTime_(std::make_shared<datatypes::Data<double>>(observationTime)), symptomatic_(std::make_shared<datatypes::Data<bool>>(symptomatic)) {
-        static int uid = 0;
-        uid_ = uid++;
+    Infection<GeneticImpl, LocusImpl>::Infection(std::string id, const double observationTime, const bool symptomatic) : id_(std::move(id)), uid_(nextUid()), observationTime_(std::make_shared<datatypes::Data<double>>(observationTime)), symptomatic_(std::make_shared<datatypes::Data<bool>>(symptomatic)) {
         infectionDuration_ = std::make_shared<parameters::Parameter<double>>(10.0);
         infectionDuration_->initializeValue(10.0);
 
@@ -253,14 +294,8 @@ namespace transmission_nets::core::containers {
         loci_.push_back(locus);
         auto lat = std::make_shared<parameters::Parameter<GeneticImpl>>(latent);
         auto ob  = std::make_shared<datatypes::Data<GeneticImpl>>(obs);
-        observedGenotype_.insert_or_assign(locus, ob);
-        latentGenotype_.insert_or_assign(locus, lat);
-        // Creating pass through of notifications
-        latentGenotype_.at(locus)->add_pre_change_listener([=, this]() { this->notify_pre_change(); });
-        latentGenotype_.at(locus)->add_post_change_listener([=, this]() { this->notify_post_change(); });
-        latentGenotype_.at(locus)->add_save_state_listener([=, this](int savedStateId) { this->notify_save_state(savedStateId); });
-        latentGenotype_.at(locus)->add_accept_state_listener([=, this]() { this->notify_accept_state(); });
-        latentGenotype_.at(locus)->add_restore_state_listener([=, this](int savedStateId) { this->notify_restore_state(savedStateId); });
+        observedGenotype_.insert_or_assign(locus, std::move(ob));
+        addLatentGenotype(locus, std::move(lat));
     }
 
     /**
@@ -277,14 +312,8 @@ namespace transmission_nets::core::containers {
         loci_.push_back(locus);
         auto ob  = std::make_shared<datatypes::Data<GeneticImpl>>(obs);
         auto lat = std::make_shared<parameters::Parameter<GeneticImpl>>(obs);
-        observedGenotype_.insert_or_assign(locus, ob);
-        latentGenotype_.insert_or_assign(locus, lat);
-        // Creating pass through of notifications
-        latentGenotype_.at(locus)->add_pre_change_listener([=, this]() { this->notify_pre_change(); });
-        latentGenotype_.at(locus)->add_post_change_listener([=, this]() { this->notify_post_change(); });
-        latentGenotype_.at(locus)->add_save_state_listener([=, this](int savedStateId) { this->notify_save_state(savedStateId); });
-        latentGenotype_.at(locus)->add_accept_state_listener([=, this]() { this->notify_accept_state(); });
-        latentGenotype_.at(locus)->add_restore_state_listener([=, this](int savedStateId) { this->notify_restore_state(savedStateId); });
+        observedGenotype_.insert_or_assign(locus, std::move(ob));
+        addLatentGenotype(locus, std::move(lat));
     }
 
 
@@ -301,13 +330,18 @@ namespace transmission_nets::core::containers {
     void Infection<GeneticImpl, LocusImpl>::addLatentGenetics(std::shared_ptr<LocusImpl> locus, const T& latent) {
         loci_.push_back(locus);
         auto lat = std::make_shared<parameters::Parameter<GeneticImpl>>(latent);
+        addLatentGenotype(locus, std::move(lat));
+    }
+
+    template<typename GeneticImpl, typename LocusImpl>
+    void Infection<GeneticImpl, LocusImpl>::addLatentGenotype(const std::shared_ptr<LocusImpl>& locus, std::shared_ptr<parameters::Parameter<GeneticImpl>> lat) {
         latentGenotype_.insert_or_assign(locus, lat);
         // Creating pass through of notifications
-        latentGenotype_.at(locus)->add_pre_change_listener([=, this]() { this->notify_pre_change(); });
-        latentGenotype_.at(locus)->add_post_change_listener([=, this]() { this->notify_post_change(); });
-        latentGenotype_.at(locus)->add_save_state_listener([=, this](int savedStateId) { this->notify_save_state(savedStateId); });
-        latentGenotype_.at(locus)->add_accept_state_listener([=, this]() { this->notify_accept_state(); });
-        latentGenotype_.at(locus)->add_restore_state_listener([=, this](int savedStateId) { this->notify_restore_state(savedStateId); });
+        lat->add_pre_change_listener([=, this]() { this->notify_pre_change(); });
+        lat->add_post_change_listener([=, this]() { this->notifyLocusChanged(locus); });
+        lat->add_save_state_listener([=, this](int savedStateId) { this->notify_save_state(savedStateId); });
+        lat->add_accept_state_listener([=, this]() { this->notify_accept_state(); });
+        lat->add_restore_state_listener([=, this](int savedStateId) { this->notify_restore_state(savedStateId); });
     }
 
 }// namespace transmission_nets::core::containers
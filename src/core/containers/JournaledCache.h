@@ -0,0 +1,207 @@
+#ifndef TRANSMISSION_NETWORKS_APP_JOURNALEDCACHE_H
+#define TRANSMISSION_NETWORKS_APP_JOURNALEDCACHE_H
+
+#include <boost/container/flat_map.hpp>
+
+#include <cassert>
+#include <optional>
+#include <utility>
+#include <vector>
+
+
+namespace transmission_nets::core::containers {
+
+    /*
+     * Key-value cache with undo-log checkpointing. Rather than copying the whole map on every checkpoint, each mutation
+     * made while a checkpoint is open records the previous state of the touched key. Checkpointing is O(1), rolling back
+     * is O(entries touched since the checkpoint) and committing discards the journal.
+     */
+    template<typename Key, typename Value, typename Map = boost::container::flat_map<Key, Value>>
+    class JournaledCache {
+    public:
+        [[nodiscard]] bool contains(const Key& key) const {
+            return entries_.find(key) != entries_.end();
+        }
+
+        [[nodiscard]] const Value& at(const Key& key) const {
+            return entries_.at(key);
+        }
+
+        /**
+         * @brief Returns a pointer to the cached value, or nullptr if the key is not cached.
+         */
+        [[nodiscard]] const Value* find(const Key& key) const {
+            auto it = entries_.find(key);
+            return it == entries_.end() ? nullptr : &(it->second);
+        }
+
+        void set(const Key& key, Value value);
+
+        /**
+         * @brief Modify the cached value of an existing key in place.
+         */
+        template<typename F>
+        void update(const Key& key, F&& f);
+
+        void erase(const Key& key);
+
+        /**
+         * @brief Erase all entries whose key satisfies the predicate.
+         */
+        template<typename Pred>
+        void eraseIf(Pred pred);
+
+        /**
+         * @brief Erase all entries. O(1) when a checkpoint is open -- the current map is moved into the journal.
+         */
+        void clear();
+
+        /**
+         * @brief Open a new checkpoint level.
+         */
+        void checkpoint() noexcept {
+            checkpoints_.push_back(journal_.size());
+        }
+
+        /**
+         * @brief Undo all mutations made since the most recent checkpoint and close it.
+         */
+        void rollback();
+
+        /**
+         * @brief Keep the current entries and close all checkpoint levels.
+         */
+        void commit() noexcept {
+            journal_.clear();
+            snapshots_.clear();
+            checkpoints_.clear();
+        }
+
+        [[nodiscard]] bool checkpointed() const noexcept {
+            return !checkpoints_.empty();
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept {
+            return entries_.size();
+        }
+
+        [[nodiscard]] auto begin() const noexcept {
+            return entries_.begin();
+        }
+
+        [[nodiscard]] auto end() const noexcept {
+            return entries_.end();
+        }
+
+    private:
+        struct JournalEntry {
+            Key key;
+            // nullopt if the key was absent before the mutation
+            std::optional<Value> previous;
+            // index into snapshots_ if the entry records a clear()
+            int snapshot = -1;
+        };
+
+        void record(const Key& key);
+
+        Map entries_{};
+        std::vector<JournalEntry> journal_{};
+        std::vector<Map> snapshots_{};
+        std::vector<std::size_t> checkpoints_{};
+    };
+
+    template<typename Key, typename Value, typename Map>
+    void JournaledCache<Key, Value, Map>::record(const Key& key) {
+        if (!checkpointed()) {
+            return;
+        }
+        auto it = entries_.find(key);
+        if (it == entries_.end()) {
+            journal_.push_back({key, std::nullopt});
+        } else {
+            journal_.push_back({key, it->second});
+        }
+    }
+
+    template<typename Key, typename Value, typename Map>
+    void JournaledCache<Key, Value, Map>::set(const Key& key, Value value) {
+        record(key);
+        entries_.insert_or_assign(key, std::move(value));
+    }
+
+    template<typename Key, typename Value, typename Map>
+    template<typename F>
+    void JournaledCache<Key, Value, Map>::update(const Key& key, F&& f) {
+        auto it = entries_.find(key);
+        assert(it != entries_.end());
+        if (checkpointed()) {
+            journal_.push_back({key, it->second});
+        }
+        f(it->second);
+    }
+
+    template<typename Key, typename Value, typename Map>
+    void JournaledCache<Key, Value, Map>::erase(const Key& key) {
+        auto it = entries_.find(key);
+        if (it == entries_.end()) {
+            return;
+        }
+        if (checkpointed()) {
+            journal_.push_back({key, std::move(it->second)});
+        }
+        entries_.erase(it);
+    }
+
+    template<typename Key, typename Value, typename Map>
+    template<typename Pred>
+    void JournaledCache<Key, Value, Map>::eraseIf(Pred pred) {
+        const bool journaled = checkpointed();
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            if (pred(it->first)) {
+                if (journaled) {
+                    journal_.push_back({it->first, std::move(it->second)});
+                }
+                it = entries_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    template<typename Key, typename Value, typename Map>
+    void JournaledCache<Key, Value, Map>::clear() {
+        if (checkpointed()) {
+            if (entries_.empty()) {
+                return;
+            }
+            snapshots_.push_back(std::move(entries_));
+            journal_.push_back({Key{}, std::nullopt, static_cast<int>(snapshots_.size()) - 1});
+        }
+        entries_.clear();
+    }
+
+    template<typename Key, typename Value, typename Map>
+    void JournaledCache<Key, Value, Map>::rollback() {
+        assert(checkpointed());
+        const std::size_t mark = checkpoints_.back();
+        checkpoints_.pop_back();
+
+        while (journal_.size() > mark) {
+            auto& entry = journal_.back();
+            if (entry.snapshot >= 0) {
+                assert(entry.snapshot == static_cast<int>(snapshots_.size()) - 1);
+                entries_ = std::move(snapshots_.back());
+                snapshots_.pop_back();
+            } else if (entry.previous) {
+                entries_.insert_or_assign(entry.key, std::move(*entry.previous));
+            } else {
+                entries_.erase(entry.key);
+            }
+            journal_.pop_back();
+        }
+    }
+
+}// namespace transmission_nets::core::containers
+
+
+#endif//TRANSMISSION_NETWORKS_APP_JOURNALEDCACHE_H
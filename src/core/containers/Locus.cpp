@@ -9,8 +9,10 @@
 
 
 namespace transmission_nets::core::containers {
-    Locus::Locus(std::string label, int total_alleles) : uid(newUID++), label(std::move(label)),
-                                                         total_alleles_(total_alleles) {}
+    Locus::Locus(std::string label, int total_alleles) : Locus(std::move(label), total_alleles, newUID) {}
+
+    Locus::Locus(std::string label, int total_alleles, std::size_t index) : uid(newUID++), label(std::move(label)), index(index),
+                                                                            total_alleles_(total_alleles) {}
     Locus::~Locus() = default;
 
     unsigned int Locus::newUID = 0;
@@ -5,6 +5,7 @@
 #ifndef TRANSMISSION_NETWORKS_APP_LOCUS_H
 #define TRANSMISSION_NETWORKS_APP_LOCUS_H
 
+#include <cstddef>
 #include <string>
 
 namespace transmission_nets::core::containers {
@@ -13,9 +14,14 @@ namespace transmission_nets::core::containers {
     public:
         const unsigned int uid;
         const std::string label;
+        // Dense index of the locus among the loci of a model, used to address per-locus storage. Loci parsed for a State are
+        // indexed 0 ... n - 1, loci constructed without an index use their uid, which is unique but not dense.
+        const std::size_t index;
 
         explicit Locus(std::string label, int total_alleles);
 
+        Locus(std::string label, int total_alleles, std::size_t index);
+
         virtual ~Locus();
 
         [[nodiscard]] unsigned int totalAlleles() const noexcept;
@@ -0,0 +1,108 @@
+#ifndef TRANSMISSION_NETWORKS_APP_LOCUSMAP_H
+#define TRANSMISSION_NETWORKS_APP_LOCUSMAP_H
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace transmission_nets::core::containers {
+
+    /*
+     * Map from loci to values, kept in insertion order and addressed by the dense index of the locus. Lookups by locus
+     * cost one indexed load, and check that the entry found belongs to that locus, so a locus from another model that
+     * shares the index is reported as missing rather than aliasing an entry.
+     */
+    template<typename LocusImpl, typename Value>
+    class LocusMap {
+    public:
+        using key_type       = std::shared_ptr<LocusImpl>;
+        using mapped_type    = Value;
+        using value_type     = std::pair<key_type, Value>;
+        using iterator       = typename std::vector<value_type>::iterator;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+        void insert_or_assign(const key_type& locus, Value value);
+
+        [[nodiscard]] bool contains(const key_type& locus) const noexcept {
+            return find(locus) != npos;
+        }
+
+        Value& at(const key_type& locus);
+        const Value& at(const key_type& locus) const;
+
+        /**
+         * @brief The value at the locus with the given dense index. The locus must be in the map.
+         */
+        const Value& atIndex(const std::size_t locusIdx) const noexcept {
+            assert(locusIdx < positions_.size() and positions_[locusIdx] != npos);
+            return entries_[positions_[locusIdx]].second;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return entries_.size(); }
+        [[nodiscard]] bool empty() const noexcept { return entries_.empty(); }
+
+        iterator begin() noexcept { return entries_.begin(); }
+        iterator end() noexcept { return entries_.end(); }
+        const_iterator begin() const noexcept { return entries_.begin(); }
+        const_iterator end() const noexcept { return entries_.end(); }
+
+    private:
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        [[nodiscard]] std::size_t find(const key_type& locus) const noexcept {
+            if (locus->index < positions_.size()) {
+                const std::size_t pos = positions_[locus->index];
+                if (pos != npos and entries_[pos].first == locus) {
+                    return pos;
+                }
+            }
+            return npos;
+        }
+
+        std::vector<value_type> entries_{};
+        // Position in entries_ of each locus, indexed by the dense index of the locus
+        std::vector<std::size_t> positions_{};
+    };
+
+    template<typename LocusImpl, typename Value>
+    void LocusMap<LocusImpl, Value>::insert_or_assign(const key_type& locus, Value value) {
+        if (const std::size_t pos = find(locus); pos != npos) {
+            entries_[pos].second = std::move(value);
+            return;
+        }
+        if (locus->index >= positions_.size()) {
+            positions_.resize(locus->index + 1, npos);
+        }
+        // Two loci sharing an index in one map would make lookups of the first one fail
+        assert(positions_[locus->index] == npos);
+        positions_[locus->index] = entries_.size();
+        entries_.emplace_back(locus, std::move(value));
+    }
+
+    template<typename LocusImpl, typename Value>
+    Value& LocusMap<LocusImpl, Value>::at(const key_type& locus) {
+        const std::size_t pos = find(locus);
+        if (pos == npos) {
+            throw std::out_of_range("No value at locus " + locus->label);
+        }
+        return entries_[pos].second;
+    }
+
+    template<typename LocusImpl, typename Value>
+    const Value& LocusMap<LocusImpl, Value>::at(const key_type& locus) const {
+        const std::size_t pos = find(locus);
+        if (pos == npos) {
+            throw std::out_of_range("No value at locus " + locus->label);
+        }
+        return entries_[pos].second;
+    }
+
+}// namespace transmission_nets::core::containers
+
+
+#endif//TRANSMISSION_NETWORKS_APP_LOCUSMAP_H
@@ -0,0 +1,257 @@
+#ifndef TRANSMISSION_NETWORKS_APP_OPENADDRESSINGMAP_H
+#define TRANSMISSION_NETWORKS_APP_OPENADDRESSINGMAP_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace transmission_nets::core::containers {
+
+    /*
+     * Linear probing hash map from packed 64 bit keys to values, stored in a single flat array of slots. Lookups touch one
+     * contiguous run of slots and insert_or_assign finds either the key or the slot to insert into in the same probe.
+     * Erased slots are marked as tombstones so iteration and erasure can be interleaved, and are reclaimed on rehash.
+     *
+     * The key values 0 and UINT64_MAX are reserved to mark empty and erased slots.
+     */
+    template<typename Value>
+    class OpenAddressingMap {
+    public:
+        using key_type   = std::uint64_t;
+        using Entry      = std::pair<key_type, Value>;
+        using value_type = Entry;
+
+        static constexpr key_type emptyKey  = 0;
+        static constexpr key_type erasedKey = ~key_type{0};
+
+        template<bool Const>
+        class Iterator {
+            using Slot = std::conditional_t<Const, const Entry, Entry>;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = Entry;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = Slot*;
+            using reference         = Slot&;
+
+            Iterator() = default;
+            Iterator(Slot* slot, Slot* end) : slot_(slot), end_(end) {
+                skipFree();
+            }
+
+            // Allow conversion from iterator to const_iterator
+            template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+            Iterator(const Iterator<OtherConst>& other) : slot_(other.slot_), end_(other.end_) {}
+
+            reference operator*() const { return *slot_; }
+            pointer operator->() const { return slot_; }
+
+            Iterator& operator++() {
+                ++slot_;
+                skipFree();
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                auto tmp = *this;
+                ++(*this);
+                return tmp;
+            }
+
+            friend bool operator==(const Iterator& lhs, const Iterator& rhs) { return lhs.slot_ == rhs.slot_; }
+            friend bool operator!=(const Iterator& lhs, const Iterator& rhs) { return lhs.slot_ != rhs.slot_; }
+
+        private:
+            friend class OpenAddressingMap;
+            template<bool>
+            friend class Iterator;
+
+            void skipFree() {
+                while (slot_ != end_ and (slot_->first == emptyKey or slot_->first == erasedKey)) {
+                    ++slot_;
+                }
+            }
+
+            Slot* slot_ = nullptr;
+            Slot* end_  = nullptr;
+        };
+
+        using iterator       = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        OpenAddressingMap() = default;
+        OpenAddressingMap(const OpenAddressingMap&) = default;
+        OpenAddressingMap& operator=(const OpenAddressingMap&) = default;
+
+        OpenAddressingMap(OpenAddressingMap&& other) noexcept
+            : slots_(std::move(other.slots_)), size_(std::exchange(other.size_, 0)), erased_(std::exchange(other.erased_, 0)) {
+            other.slots_.clear();
+        }
+
+        OpenAddressingMap& operator=(OpenAddressingMap&& other) noexcept {
+            slots_  = std::move(other.slots_);
+            size_   = std::exchange(other.size_, 0);
+            erased_ = std::exchange(other.erased_, 0);
+            other.slots_.clear();
+            return *this;
+        }
+
+        [[nodiscard]] iterator begin() noexcept { return {slots_.data(), slots_.data() + slots_.size()}; }
+        [[nodiscard]] iterator end() noexcept { return {slots_.data() + slots_.size(), slots_.data() + slots_.size()}; }
+        [[nodiscard]] const_iterator begin() const noexcept { return {slots_.data(), slots_.data() + slots_.size()}; }
+        [[nodiscard]] const_iterator end() const noexcept { return {slots_.data() + slots_.size(), slots_.data() + slots_.size()}; }
+
+        [[nodiscard]] std::size_t size() const noexcept { return size_; }
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+        [[nodiscard]] iterator find(key_type key) noexcept {
+            const std::size_t idx = findIndex(key);
+            return idx == npos ? end() : iterator{slots_.data() + idx, slots_.data() + slots_.size()};
+        }
+
+        [[nodiscard]] const_iterator find(key_type key) const noexcept {
+            const std::size_t idx = findIndex(key);
+            return idx == npos ? end() : const_iterator{slots_.data() + idx, slots_.data() + slots_.size()};
+        }
+
+        [[nodiscard]] const Value& at(key_type key) const {
+            const std::size_t idx = findIndex(key);
+            if (idx == npos) {
+                throw std::out_of_range("OpenAddressingMap::at");
+            }
+            return slots_[idx].second;
+        }
+
+        std::pair<iterator, bool> insert_or_assign(key_type key, Value value);
+
+        iterator erase(iterator it) noexcept {
+            assert(it != end());
+            eraseSlot(*it.slot_);
+            ++it;
+            return it;
+        }
+
+        std::size_t erase(key_type key) noexcept {
+            const std::size_t idx = findIndex(key);
+            if (idx == npos) {
+                return 0;
+            }
+            eraseSlot(slots_[idx]);
+            return 1;
+        }
+
+        void clear() noexcept {
+            slots_.clear();
+            size_   = 0;
+            erased_ = 0;
+        }
+
+    private:
+        static constexpr std::size_t npos        = ~std::size_t{0};
+        static constexpr std::size_t minCapacity = 16;
+
+        [[nodiscard]] std::size_t home(key_type key) const noexcept {
+            // Fibonacci hashing, the capacity is a power of two
+            return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32) & (slots_.size() - 1);
+        }
+
+        [[nodiscard]] std::size_t findIndex(key_type key) const noexcept;
+
+        void eraseSlot(value_type& slot) noexcept {
+            slot.first  = erasedKey;
+            slot.second = Value{};
+            size_--;
+            erased_++;
+        }
+
+        void rehash(std::size_t capacity);
+
+        std::vector<value_type> slots_{};
+        std::size_t size_   = 0;
+        std::size_t erased_ = 0;
+    };
+
+    template<typename Value>
+    std::size_t OpenAddressingMap<Value>::findIndex(const key_type key) const noexcept {
+        assert(key != emptyKey and key != erasedKey);
+        if (slots_.empty()) {
+            return npos;
+        }
+        const std::size_t mask = slots_.size() - 1;
+        for (std::size_t idx = home(key);; idx = (idx + 1) & mask) {
+            const key_type slotKey = slots_[idx].first;
+            if (slotKey == key) {
+                return idx;
+            }
+            if (slotKey == emptyKey) {
+                return npos;
+            }
+        }
+    }
+
+    template<typename Value>
+    auto OpenAddressingMap<Value>::insert_or_assign(const key_type key, Value value) -> std::pair<iterator, bool> {
+        assert(key != emptyKey and key != erasedKey);
+        // Keep at most 3/4 of the slots in use so probe runs stay short
+        if (4 * (size_ + erased_ + 1) > 3 * slots_.size()) {
+            rehash(4 * (size_ + 1) > 2 * slots_.size() ? std::max(minCapacity, 2 * slots_.size()) : slots_.size());
+        }
+
+        const std::size_t mask = slots_.size() - 1;
+        std::size_t target     = npos;
+        for (std::size_t idx = home(key);; idx = (idx + 1) & mask) {
+            auto& slot = slots_[idx];
+            if (slot.first == key) {
+                slot.second = std::move(value);
+                return {iterator{&slot, slots_.data() + slots_.size()}, false};
+            }
+            if (slot.first == erasedKey and target == npos) {
+                target = idx;
+            } else if (slot.first == emptyKey) {
+                if (target == npos) {
+                    target = idx;
+                }
+                break;
+            }
+        }
+
+        auto& slot = slots_[target];
+        if (slot.first == erasedKey) {
+            erased_--;
+        }
+        slot = {key, std::move(value)};
+        size_++;
+        return {iterator{&slot, slots_.data() + slots_.size()}, true};
+    }
+
+    template<typename Value>
+    void OpenAddressingMap<Value>::rehash(const std::size_t capacity) {
+        assert((capacity & (capacity - 1)) == 0);
+        std::vector<value_type> old(capacity);
+        std::swap(old, slots_);
+        erased_ = 0;
+
+        const std::size_t mask = slots_.size() - 1;
+        for (auto& slot : old) {
+            if (slot.first == emptyKey or slot.first == erasedKey) {
+                continue;
+            }
+            std::size_t idx = home(slot.first);
+            while (slots_[idx].first != emptyKey) {
+                idx = (idx + 1) & mask;
+            }
+            slots_[idx] = std::move(slot);
+        }
+    }
+
+}// namespace transmission_nets::core::containers
+
+
+#endif//TRANSMISSION_NETWORKS_APP_OPENADDRESSINGMAP_H
@@ -7,6 +7,11 @@
 
 #include <boost/container/flat_set.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <functional>
 #include <memory>
 
 
@@ -15,6 +20,53 @@ namespace transmission_nets::core::containers {
     template<typename ElementType>
     using ParentSet = boost::container::flat_set<std::shared_ptr<ElementType>>;
 
-}
+    /*
+     * Non-owning parent set of bounded size, for building candidate parent sets in the likelihood hot path. Members are
+     * borrowed from whoever owns them, so inserting and clearing never touch reference counts. Members are kept in the
+     * order a ParentSet of the same elements iterates them, so anything folded over either visits the same sequence.
+     */
+    template<typename ElementType, std::size_t Capacity>
+    class BorrowedParentSet {
+    public:
+        using value_type     = const ElementType*;
+        using const_iterator = typename std::array<value_type, Capacity>::const_iterator;
+
+        BorrowedParentSet() = default;
+
+        explicit BorrowedParentSet(const ElementType* element) {
+            insert(element);
+        }
+
+        void insert(const ElementType* element) noexcept {
+            auto pos = std::lower_bound(elements_.begin(), elements_.begin() + size_, element, std::less<>{});
+            if (pos != elements_.begin() + size_ and *pos == element) {
+                return;
+            }
+            assert(size_ < Capacity);
+            std::move_backward(pos, elements_.begin() + size_, elements_.begin() + size_ + 1);
+            *pos = element;
+            ++size_;
+        }
+
+        void insert(const std::shared_ptr<ElementType>& element) noexcept {
+            insert(element.get());
+        }
+
+        void clear() noexcept {
+            size_ = 0;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return size_; }
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+        [[nodiscard]] const_iterator begin() const noexcept { return elements_.begin(); }
+        [[nodiscard]] const_iterator end() const noexcept { return elements_.begin() + size_; }
+
+    private:
+        std::array<value_type, Capacity> elements_{};
+        std::size_t size_ = 0;
+    };
+
+}// namespace transmission_nets::core::containers
 
 #endif//TRANSMISSION_NETWORKS_APP_PARENTSET_H
@@ -5,8 +5,12 @@
 #ifndef TRANSMISSION_NETWORKS_APP_ALLELE_H
 #define TRANSMISSION_NETWORKS_APP_ALLELE_H
 
+#include <bit>
 #include <bitset>
 #include <cassert>
+#include <cstdint>
+#include <functional>
+#include <string>
 #include <vector>
 
 
@@ -14,6 +18,8 @@ namespace transmission_nets::core::datatypes {
     template<int MaxAlleles>
     class AllelesBitSet {
     public:
+        static constexpr int maxAlleles = MaxAlleles;
+
         explicit AllelesBitSet(const std::string& bitstr);
         explicit AllelesBitSet(int totalAlleles);
         AllelesBitSet();
@@ -23,6 +29,10 @@ namespace transmission_nets::core::datatypes {
         bool operator==(const AllelesBitSet& rhs) const;
         bool operator!=(const AllelesBitSet& rhs) const;
 
+        [[nodiscard]] std::size_t hash() const noexcept {
+            return std::hash<std::bitset<MaxAlleles>>{}(alleles_) ^ total_alleles_;
+        }
+
         AllelesBitSet(const AllelesBitSet& other)
             : total_alleles_(other.total_alleles_),
               alleles_(other.alleles_),
@@ -77,6 +87,12 @@ namespace transmission_nets::core::datatypes {
         [[nodiscard]] constexpr static unsigned int
         falseNegativeCount(const AllelesBitSet<MaxAlleles>& parent, const AllelesBitSet<MaxAlleles>& child) noexcept;
 
+        /**
+         * @brief True if every allele present in the child is also present in the parent.
+         */
+        [[nodiscard]] constexpr static bool
+        covers(const AllelesBitSet<MaxAlleles>& parent, const AllelesBitSet<MaxAlleles>& child) noexcept;
+
         [[nodiscard]] constexpr static AllelesBitSet<MaxAlleles>
                 shared(const AllelesBitSet<MaxAlleles>& lhs, const AllelesBitSet<MaxAlleles>& rhs) noexcept;
 
@@ -107,6 +123,20 @@ namespace transmission_nets::core::datatypes {
 
         [[nodiscard]] constexpr bool allele(size_t pos) const noexcept;
 
+        /**
+         * @brief Call f(pos) for each allele present, in increasing order of pos. Only the set bits are visited.
+         */
+        template<typename F>
+        constexpr void forEachAllele(F&& f) const noexcept;
+
+        /**
+         * @brief Call f(pos, other.allele(pos)) for each allele present, in increasing order of pos.
+         */
+        template<typename F>
+        constexpr void forEachAlleleWith(const AllelesBitSet& other, F&& f) const noexcept {
+            forEachAllele([&](const std::size_t pos) { f(pos, other.allele(pos)); });
+        }
+
     private:
         unsigned int total_alleles_ = 0;
         std::bitset<MaxAlleles> alleles_{};
@@ -176,6 +206,12 @@ namespace transmission_nets::core::datatypes {
         return (~child.alleles_ & parent.alleles_).count();
     }
 
+    template<int MaxAlleles>
+    constexpr bool AllelesBitSet<MaxAlleles>::covers(const AllelesBitSet<MaxAlleles>& parent,
+                                                     const AllelesBitSet<MaxAlleles>& child) noexcept {
+        return (child.alleles_ & ~parent.alleles_).none();
+    }
+
     template<int MaxAlleles>
     std::string AllelesBitSet<MaxAlleles>::allelesStr() const noexcept {
         return alleles_.to_string().substr(MaxAlleles - total_alleles_, total_alleles_);
@@ -234,6 +270,25 @@ namespace transmission_nets::core::datatypes {
         return alleles_[total_alleles_ - 1 - pos];
     }
 
+    template<int MaxAlleles>
+    template<typename F>
+    constexpr void AllelesBitSet<MaxAlleles>::forEachAllele(F&& f) const noexcept {
+        // Allele pos is stored at bit (total_alleles_ - 1 - pos), so walk the words from the most significant bit down
+        constexpr std::size_t wordBits = 64;
+        const std::bitset<MaxAlleles> wordMask{~0ULL};
+        for (std::size_t w = (total_alleles_ + wordBits - 1) / wordBits; w-- > 0;) {
+            unsigned long long word = ((alleles_ >> (w * wordBits)) & wordMask).to_ullong();
+            while (word != 0) {
+                const std::size_t offset = std::bit_width(word) - 1;
+                word ^= 1ULL << offset;
+                const std::size_t bit = w * wordBits + offset;
+                if (bit < total_alleles_) {
+                    f(total_alleles_ - 1 - bit);
+                }
+            }
+        }
+    }
+
     template<int MaxAlleles>
     std::string AllelesBitSet<MaxAlleles>::serialize() const noexcept {
         return allelesStr();
@@ -304,6 +359,211 @@ namespace transmission_nets::core::datatypes {
         result.mask_ = this->mask_;
         return result;
     }
+
+    /*
+     * Single word specialization for loci with at most 64 alleles. The alleles and mask are each a single 64 bit word, so
+     * copies and checkpoints are trivial and the counts and set operations compile to a single and/or/andn plus popcount.
+     * Behaves exactly as the bitset implementation of the same width: bits above MaxAlleles are never set.
+     */
+    template<int MaxAlleles>
+        requires(MaxAlleles <= 64)
+    class AllelesBitSet<MaxAlleles> {
+        using Word = std::uint64_t;
+
+        static constexpr Word widthMask = MaxAlleles == 64 ? ~Word{0} : (Word{1} << MaxAlleles) - 1;
+
+    public:
+        static constexpr int maxAlleles = MaxAlleles;
+
+        explicit AllelesBitSet(const std::string& bitstr) : total_alleles_(bitstr.size()) {
+            assert(bitstr.size() <= MaxAlleles);
+            for (const char c : bitstr) {
+                assert(c == '0' or c == '1');
+                alleles_ = (alleles_ << 1) | Word(c == '1');
+            }
+            mask_ = lowBits(total_alleles_);
+        }
+
+        explicit AllelesBitSet(int totalAlleles) : total_alleles_(totalAlleles), alleles_(1) {
+            assert(totalAlleles > 0 and totalAlleles <= MaxAlleles);
+        }
+
+        AllelesBitSet() = default;
+
+        bool operator==(const AllelesBitSet& rhs) const {
+            return total_alleles_ == rhs.total_alleles_ and alleles_ == rhs.alleles_;
+        }
+
+        bool operator!=(const AllelesBitSet& rhs) const {
+            return !(*this == rhs);
+        }
+
+        [[nodiscard]] std::size_t hash() const noexcept {
+            return std::hash<Word>{}(alleles_) ^ total_alleles_;
+        }
+
+        [[nodiscard]] std::string serialize() const noexcept {
+            return allelesStr();
+        }
+
+        [[nodiscard]] constexpr unsigned int totalPositiveCount() const noexcept {
+            return std::popcount(alleles_);
+        }
+
+        [[nodiscard]] constexpr unsigned int totalNegativeCount() const noexcept {
+            return total_alleles_ - std::popcount(alleles_);
+        }
+
+        [[nodiscard]] constexpr static unsigned int
+        truePositiveCount(const AllelesBitSet& parent, const AllelesBitSet& child) noexcept {
+            return std::popcount(child.alleles_ & parent.alleles_);
+        }
+
+        [[nodiscard]] constexpr static unsigned int
+        trueNegativeCount(const AllelesBitSet& parent, const AllelesBitSet& child) noexcept {
+            return std::popcount(~(child.alleles_ | parent.alleles_) & widthMask) - (MaxAlleles - child.totalAlleles());
+        }
+
+        [[nodiscard]] constexpr static unsigned int
+        falsePositiveCount(const AllelesBitSet& parent, const AllelesBitSet& child) noexcept {
+            return std::popcount(child.alleles_ & ~parent.alleles_);
+        }
+
+        [[nodiscard]] constexpr static unsigned int
+        falseNegativeCount(const AllelesBitSet& parent, const AllelesBitSet& child) noexcept {
+            return std::popcount(~child.alleles_ & parent.alleles_);
+        }
+
+        /**
+         * @brief True if every allele present in the child is also present in the parent.
+         */
+        [[nodiscard]] constexpr static bool
+        covers(const AllelesBitSet& parent, const AllelesBitSet& child) noexcept {
+            return (child.alleles_ & ~parent.alleles_) == 0;
+        }
+
+        [[nodiscard]] constexpr static AllelesBitSet
+        shared(const AllelesBitSet& lhs, const AllelesBitSet& rhs) noexcept {
+            return {lhs.alleles_ & rhs.alleles_, lhs};
+        }
+
+        [[nodiscard]] constexpr static AllelesBitSet
+        any(const AllelesBitSet& lhs, const AllelesBitSet& rhs) noexcept {
+            return {lhs.alleles_ | rhs.alleles_, lhs};
+        }
+
+        [[nodiscard]] constexpr static AllelesBitSet
+        diff(const AllelesBitSet& lhs, const AllelesBitSet& rhs) noexcept {
+            return {lhs.alleles_ ^ rhs.alleles_, lhs};
+        }
+
+        [[nodiscard]] constexpr static AllelesBitSet
+        invert(const AllelesBitSet& alleles) noexcept {
+            return {~alleles.alleles_ & alleles.mask_, alleles};
+        }
+
+        [[nodiscard]] std::string allelesStr() const noexcept {
+            std::string bitstr(total_alleles_, '0');
+            for (unsigned int pos = 0; pos < total_alleles_; ++pos) {
+                if (allele(pos)) {
+                    bitstr[pos] = '1';
+                }
+            }
+            return bitstr;
+        }
+
+        [[nodiscard]] std::string compactAllelesStr() const noexcept {
+            return std::to_string(std::stoll(allelesStr()));
+        }
+
+        [[nodiscard]] constexpr unsigned int totalAlleles() const noexcept {
+            return total_alleles_;
+        }
+
+        constexpr void flip(size_t pos) noexcept {
+            alleles_ ^= bit(pos);
+        }
+
+        void flip(std::vector<unsigned int> pos) noexcept {
+            for (auto& p : pos) {
+                flip(p);
+            }
+        }
+
+        constexpr void set(size_t pos, bool val = true) noexcept {
+            alleles_ = val ? alleles_ | bit(pos) : alleles_ & ~bit(pos);
+        }
+
+        constexpr void set() noexcept {
+            alleles_ = widthMask;
+        }
+
+        constexpr void reset(size_t pos) noexcept {
+            alleles_ &= ~bit(pos);
+        }
+
+        constexpr void reset() noexcept {
+            alleles_ = 0;
+        }
+
+        constexpr AllelesBitSet mutationMask(const AllelesBitSet& parent) const noexcept {
+            // The mutation mask gets the alleles that are present in the child but not in the parent
+            return {~parent.alleles_ & alleles_, *this};
+        }
+
+        [[nodiscard]] constexpr bool allele(size_t pos) const noexcept {
+            return (alleles_ & bit(pos)) != 0;
+        }
+
+        /**
+         * @brief Call f(pos) for each allele present, in increasing order of pos. Only the set bits are visited.
+         */
+        template<typename F>
+        constexpr void forEachAllele(F&& f) const noexcept {
+            // Allele pos is stored at bit (total_alleles_ - 1 - pos), so walk from the most significant bit down
+            Word word = alleles_ & lowBits(total_alleles_);
+            while (word != 0) {
+                const std::size_t offset = std::bit_width(word) - 1;
+                word ^= Word{1} << offset;
+                f(total_alleles_ - 1 - offset);
+            }
+        }
+
+        /**
+         * @brief Call f(pos, other.allele(pos)) for each allele present, in increasing order of pos.
+         */
+        template<typename F>
+        constexpr void forEachAlleleWith(const AllelesBitSet& other, F&& f) const noexcept {
+            forEachAllele([&](const std::size_t pos) { f(pos, other.allele(pos)); });
+        }
+
+    private:
+        // Result of a set operation, sized and masked like the operand it is derived from
+        constexpr AllelesBitSet(const Word alleles, const AllelesBitSet& like) noexcept
+            : total_alleles_(like.total_alleles_), alleles_(alleles), mask_(like.mask_) {}
+
+        static constexpr Word lowBits(const unsigned int count) noexcept {
+            return count >= 64 ? ~Word{0} : (Word{1} << count) - 1;
+        }
+
+        [[nodiscard]] constexpr Word bit(const size_t pos) const noexcept {
+            // Bits are accessed right to left, as with std::bitset, so we're converting to left to right accession
+            assert(pos < total_alleles_);
+            return Word{1} << (total_alleles_ - 1 - pos);
+        }
+
+        unsigned int total_alleles_ = 0;
+        Word alleles_               = 0;
+        Word mask_                  = 0;
+    };
+
+    /**
+     * @brief Narrowest AllelesBitSet width holding maxAlleles alleles. Loci with at most 64 alleles get the single word
+     * specialization, wider loci a whole number of words.
+     */
+    constexpr int allelesBitSetWidth(const int maxAlleles) noexcept {
+        return maxAlleles <= 64 ? 64 : (maxAlleles + 63) / 64 * 64;
+    }
 //
 //    template<int MaxAlleles>
 //    class AllelesBitArray {
@@ -568,5 +828,12 @@ namespace transmission_nets::core::datatypes {
 //    }
 }// namespace transmission_nets::core::datatypes
 
+template<int MaxAlleles>
+struct std::hash<transmission_nets::core::datatypes::AllelesBitSet<MaxAlleles>> {
+    std::size_t operator()(const transmission_nets::core::datatypes::AllelesBitSet<MaxAlleles>& alleles) const noexcept {
+        return alleles.hash();
+    }
+};
+
 
 #endif//TRANSMISSION_NETWORKS_APP_ALLELE_H
\ No newline at end of file
@@ -9,63 +9,29 @@
 
 namespace transmission_nets::core::datatypes {
 
-    Simplex::Simplex(const unsigned char totalElements) : total_elements_(totalElements) {
-        assert(total_elements_ > 0);
-        coefficients_.fill(1.0 / total_elements_);
+    Simplex::Simplex(const unsigned int totalElements) : coefficients_(totalElements, 1.0 / totalElements) {
+        assert(totalElements > 0);
         min_ = coefficients_[0];
         max_ = coefficients_[0];
     }
 
-    Simplex::Simplex(const std::initializer_list<double>& freqs) : total_elements_(static_cast<char>(freqs.size())), min_(std::numeric_limits<double>::max()), max_(std::numeric_limits<double>::min()) {
-        coefficients_.fill(0);
-        assert(total_elements_ > 0);
+    Simplex::Simplex(const std::initializer_list<double>& freqs) : coefficients_(freqs.size(), 0.0), min_(std::numeric_limits<double>::max()), max_(std::numeric_limits<double>::min()) {
+        assert(!coefficients_.empty());
         set(freqs);
     }
 
-    Simplex::Simplex(const std::vector<double>& freqs) : total_elements_(static_cast<char>(freqs.size())), min_(std::numeric_limits<double>::max()), max_(std::numeric_limits<double>::min()) {
-        coefficients_.fill(0);
-        assert(total_elements_ > 0);
+    Simplex::Simplex(const std::vector<double>& freqs) : coefficients_(freqs.size(), 0.0), min_(std::numeric_limits<double>::max()), max_(std::numeric_limits<double>::min()) {
+        assert(!coefficients_.empty());
         set(freqs);
     }
 
-    Simplex::Simplex(const Simplex& other) : coefficients_(other.coefficients_), total_elements_(other.total_elements_), min_(other.min_), max_(other.max_) {}
-
-    Simplex::Simplex(Simplex&& other) noexcept : coefficients_(other.coefficients_), total_elements_(other.total_elements_), min_(other.min_), max_(other.max_) {
-        other.coefficients_ = {};
-        other.total_elements_ = 0;
-        other.min_ = std::numeric_limits<double>::min();
-        other.max_ = std::numeric_limits<double>::max();
-    }
-
-    Simplex& Simplex::operator=(Simplex&& other) noexcept {
-        coefficients_ = other.coefficients_;
-        total_elements_ = other.total_elements_;
-        min_ = other.min_;
-        max_ = other.max_;
-
-        other.coefficients_ = {};
-        other.total_elements_ = 0;
-        other.min_ = std::numeric_limits<double>::min();
-        other.max_ = std::numeric_limits<double>::max();
-
-        return *this;
-    }
-
-    Simplex& Simplex::operator=(const Simplex& other) noexcept {
-        coefficients_ = other.coefficients_;
-        total_elements_ = other.total_elements_;
-        min_ = other.min_;
-        max_ = other.max_;
-
-        return *this;
-    }
-
     void Simplex::set(const std::vector<double>& valueArray) {
-        assert(valueArray.size() == total_elements_);
+        const std::size_t totalElements = coefficients_.size();
+        assert(valueArray.size() == totalElements);
         min_       = std::numeric_limits<double>::max();
         max_       = std::numeric_limits<double>::min();
         double sum = 0;
-        for (unsigned int ii = 0; ii < total_elements_; ++ii) {
+        for (std::size_t ii = 0; ii < totalElements; ++ii) {
             coefficients_[ii] = valueArray[ii];
             sum += valueArray[ii];
             min_ = std::min(min_, coefficients_[ii]);
@@ -75,7 +41,7 @@ namespace transmission_nets::core::datatypes {
         if (sum != 1.0) {
             min_ = std::numeric_limits<double>::max();
             max_ = std::numeric_limits<double>::min();
-            for (unsigned char ii = 0; ii < total_elements_; ++ii) {
+            for (std::size_t ii = 0; ii < totalElements; ++ii) {
                 coefficients_[ii] = coefficients_[ii] / sum;
                 min_              = std::min(min_, coefficients_[ii]);
                 max_              = std::max(max_, coefficients_[ii]);
@@ -83,13 +49,13 @@ namespace transmission_nets::core::datatypes {
         }
     }
 
-    void Simplex::set(const unsigned char idx, const double value) {
-        assert(idx < total_elements_);
+    void Simplex::set(const std::size_t idx, const double value) {
+        assert(idx < coefficients_.size());
         min_               = std::numeric_limits<double>::max();
         max_               = std::numeric_limits<double>::min();
         const double prev_value  = coefficients_[idx];
         coefficients_[idx] = 0.0f;
-        for (unsigned char ii = 0; ii < total_elements_; ++ii) {
+        for (std::size_t ii = 0; ii < coefficients_.size(); ++ii) {
             coefficients_[ii] = (coefficients_[ii] / (1 - prev_value)) * (1 - value);
             min_              = std::min(min_, coefficients_[ii]);
             max_              = std::max(max_, coefficients_[ii]);
@@ -99,24 +65,12 @@ namespace transmission_nets::core::datatypes {
         max_               = std::max(max_, coefficients_[idx]);
     }
 
-    double Simplex::frequencies(const unsigned char idx) const noexcept {
-        return coefficients_[idx];
-    }
-
     std::vector<double> Simplex::frequencies() const noexcept {
-        std::vector freqs(total_elements_, 0.0);
-        for (unsigned char ii = 0; ii < total_elements_; ++ii) {
-            freqs[ii] = coefficients_[ii];
-        }
-        return freqs;
-    }
-
-    unsigned char Simplex::totalElements() const noexcept {
-        return total_elements_;
+        return {coefficients_.begin(), coefficients_.end()};
     }
 
     std::ostream& operator<<(std::ostream& os, const Simplex& simplex) {
-        os << "frequencies: " << io::serialize(simplex.coefficients_);
+        os << "frequencies: " << io::serialize(simplex.frequencies());
         return os;
     }
 
@@ -9,6 +9,8 @@
 #include "core/datatypes/Matrix.h"
 
 
+#include <boost/container/small_vector.hpp>
+
 #include <fmt/core.h>
 
 #include <vector>
@@ -16,34 +18,34 @@
 
 namespace transmission_nets::core::datatypes {
 
+    /*
+     * Frequencies over a variable number of elements, sized by the locus. Storage is inline for loci with up to 32 alleles
+     * and on the heap for larger loci, so copies cost O(alleles at the locus) rather than a fixed maximum.
+     */
     class Simplex {
     public:
-        explicit Simplex(unsigned char totalElements);
-        Simplex();
+        explicit Simplex(unsigned int totalElements);
+        Simplex() = default;
 
         explicit Simplex(const std::vector<double>& freqs);
 
         Simplex(const std::initializer_list<double>& freqs);
 
-        Simplex(const Simplex& other);
-
-        Simplex(Simplex&& other) noexcept;
-
-        Simplex& operator=(Simplex&& other) noexcept;
-
-        Simplex& operator=(const Simplex& other) noexcept;
-
         friend std::ostream& operator<<(std::ostream& os, const Simplex& simplex);
 
         void set(const std::vector<double>& valueArray);
 
-        void set(unsigned char idx, double value);
+        void set(std::size_t idx, double value);
 
-        [[nodiscard]] double frequencies(unsigned char idx) const noexcept;
+        [[nodiscard]] double frequencies(const std::size_t idx) const noexcept {
+            return coefficients_[idx];
+        }
 
         [[nodiscard]] std::vector<double> frequencies() const noexcept;
 
-        [[nodiscard]] unsigned char totalElements() const noexcept;
+        [[nodiscard]] unsigned int totalElements() const noexcept {
+            return coefficients_.size();
+        }
 
         [[nodiscard]] double min() const noexcept;
 
@@ -52,12 +54,9 @@ namespace transmission_nets::core::datatypes {
         [[nodiscard]] std::string serialize() const noexcept;
 
     private:
-        // std::vector<float> coefficients_{};
-        // todo: this needs to match up with the max number of alleles
-        std::array<double, 128> coefficients_{};
-        unsigned char total_elements_;
-        double min_;
-        double max_;
+        boost::container::small_vector<double, 32> coefficients_{};
+        double min_ = 0;
+        double max_ = 0;
     };
 
 }// namespace transmission_nets::core::datatypes
@@ -3,56 +3,24 @@
 //
 
 #include "SparseAlleleSet.h"
+
 #include <cassert>
-#include <cstddef>
-#include <cstdint>
-#include <cstdlib>
-#include <cstring>
-#include <stdexcept>
+#include <string>
 
 namespace transmission_nets::core::datatypes {
     SparseAlleleSet::SparseAlleleSet(const std::string& bitstr) : total_alleles_(bitstr.size()) {
-        updateSetPositionsFromBitString(bitstr);
-    }
-
-    SparseAlleleSet::SparseAlleleSet(unsigned int totalAlleles) : total_alleles_(totalAlleles) {
-        std::memset(set_positions_, 0, sizeof(set_positions_));
-    }
-
-    SparseAlleleSet::SparseAlleleSet(const SparseAlleleSet& other) {
-        set_count_ = other.set_count_;
-        total_alleles_ = other.total_alleles_;
-        std::memcpy(set_positions_, other.set_positions_, sizeof(set_positions_));
-    }
-
-    SparseAlleleSet::SparseAlleleSet(SparseAlleleSet&& other) noexcept {
-        set_count_ = other.set_count_;
-        total_alleles_ = other.total_alleles_;
-        std::memcpy(set_positions_, other.set_positions_, sizeof(set_positions_));
-    }
-
-    SparseAlleleSet::SparseAlleleSet() {
-        set_count_ = 0;
-        total_alleles_ = 0;
-        std::memset(set_positions_, 0, sizeof(set_positions_));
-    }
-
-    SparseAlleleSet& SparseAlleleSet::operator=(const SparseAlleleSet& other) {
-        if (this != &other) {
-            set_count_ = other.set_count_;
-            total_alleles_ = other.total_alleles_;
-            std::memcpy(set_positions_, other.set_positions_, sizeof(set_positions_));
+        assert(bitstr.size() <= static_cast<std::size_t>(maxAlleles));
+        for (std::size_t i = 0; i < bitstr.size(); ++i) {
+            if (bitstr[i] == '1') {
+                alleles_.push_back(static_cast<Allele>(i));
+            }
         }
-        return *this;
     }
 
-    SparseAlleleSet& SparseAlleleSet::operator=(SparseAlleleSet&& other) noexcept {
-        if (this != &other) {
-            set_count_ = other.set_count_;
-            total_alleles_ = other.total_alleles_;
-            std::memcpy(set_positions_, other.set_positions_, sizeof(set_positions_));
-        }
-        return *this;
+    SparseAlleleSet::SparseAlleleSet(const unsigned int totalAlleles) : total_alleles_(totalAlleles) {
+        // Matches AllelesBitSet, which sets the last allele
+        assert(totalAlleles > 0 and totalAlleles <= static_cast<unsigned int>(maxAlleles));
+        alleles_.push_back(static_cast<Allele>(totalAlleles - 1));
     }
 
     std::ostream& operator<<(std::ostream& os, const SparseAlleleSet& alleles) noexcept {
@@ -60,13 +28,24 @@ namespace transmission_nets::core::datatypes {
         return os;
     }
 
-    bool SparseAlleleSet::operator==(const SparseAlleleSet& rhs) const {
-        return total_alleles_ == rhs.total_alleles_ && set_count_ == rhs.set_count_ &&
-               std::memcmp(set_positions_, rhs.set_positions_, sizeof(set_positions_)) != 0;
+    SparseAlleleSet SparseAlleleSet::invert(const SparseAlleleSet& alleles) noexcept {
+        SparseAlleleSet result(alleles.total_alleles_, {});
+        auto present = alleles.alleles_.begin();
+        for (unsigned int pos = 0; pos < alleles.total_alleles_; ++pos) {
+            if (present != alleles.alleles_.end() and *present == pos) {
+                ++present;
+            } else {
+                result.alleles_.push_back(static_cast<Allele>(pos));
+            }
+        }
+        return result;
     }
 
-    bool SparseAlleleSet::operator!=(const SparseAlleleSet& rhs) const {
-        return!(*this == rhs);
+    void SparseAlleleSet::set() noexcept {
+        alleles_.clear();
+        for (unsigned int pos = 0; pos < total_alleles_; ++pos) {
+            alleles_.push_back(static_cast<Allele>(pos));
+        }
     }
 
     std::string SparseAlleleSet::serialize() const noexcept {
@@ -75,14 +54,14 @@ namespace transmission_nets::core::datatypes {
 
     std::string SparseAlleleSet::allelesStr() const noexcept {
         std::string str(total_alleles_, '0');
-        for (unsigned int i = 0; i < set_count_; ++i) {
-            str[set_positions_[i]] = '1';
+        for (const auto pos : alleles_) {
+            str[pos] = '1';
         }
         return str;
     }
 
     std::string SparseAlleleSet::compactAllelesStr() const noexcept {
-        return std::to_string(std::stoull(allelesStr(), nullptr, 2));
+        return std::to_string(std::stoll(allelesStr()));
     }
 
-};
+}// namespace transmission_nets::core::datatypes
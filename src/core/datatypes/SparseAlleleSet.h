@@ -5,229 +5,216 @@
 #ifndef SPARSEALLELESET_H
 #define SPARSEALLELESET_H
 
+#include <boost/container/small_vector.hpp>
+
 #include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <string>
 #include <vector>
-#include <array>
-#include <cstring>
 
 namespace transmission_nets::core::datatypes {
+
+    /*
+     * Genotype stored as the sorted positions of the alleles present, for loci with many alleles of which an infection
+     * carries only a few. Counts and set operations merge the two position lists, so they cost O(alleles present) rather
+     * than O(alleles at the locus). Positions are numbered left to right in the allele string, as with AllelesBitSet, and
+     * the interface mirrors AllelesBitSet so either can be used as the genetics implementation.
+     */
     class SparseAlleleSet {
-        static constexpr unsigned int MAX_SIZE = 30;
     public:
+        using Allele = std::uint16_t;
+        // Inline storage for the alleles of a typical infection, more spill to the heap
+        using Alleles = boost::container::small_vector<Allele, 14>;
+
+        static constexpr int maxAlleles = std::numeric_limits<Allele>::max();
+
         explicit SparseAlleleSet(const std::string& bitstr);
         explicit SparseAlleleSet(unsigned int totalAlleles);
-        constexpr SparseAlleleSet(unsigned int totalAlleles, const std::array<unsigned char, MAX_SIZE>& set_positions) : total_alleles_(totalAlleles) {
-            set_count_ = set_positions.size();
-            std::memcpy(set_positions_, set_positions.data(), sizeof(set_positions_));
-        }
-        SparseAlleleSet(const SparseAlleleSet& other);
-        SparseAlleleSet(SparseAlleleSet&& other) noexcept;
-        SparseAlleleSet();
-
-        SparseAlleleSet& operator=(const SparseAlleleSet& other);
-        SparseAlleleSet& operator=(SparseAlleleSet&& other) noexcept ;
+        SparseAlleleSet() = default;
 
         friend std::ostream& operator<<(std::ostream& os, const SparseAlleleSet& alleles) noexcept;
-        bool operator==(const SparseAlleleSet& rhs) const;
-        bool operator!=(const SparseAlleleSet& rhs) const;
 
+        bool operator==(const SparseAlleleSet& rhs) const {
+            return total_alleles_ == rhs.total_alleles_ and alleles_ == rhs.alleles_;
+        }
+
+        bool operator!=(const SparseAlleleSet& rhs) const {
+            return !(*this == rhs);
+        }
+
+        [[nodiscard]] std::size_t hash() const noexcept {
+            std::size_t seed = total_alleles_;
+            for (const auto pos : alleles_) {
+                seed ^= std::hash<Allele>{}(pos) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            }
+            return seed;
+        }
 
         [[nodiscard]] std::string serialize() const noexcept;
-        [[nodiscard]] constexpr unsigned int totalPositiveCount() const noexcept {
-            return set_count_;
+
+        [[nodiscard]] unsigned int totalPositiveCount() const noexcept {
+            return alleles_.size();
         }
-        [[nodiscard]] constexpr unsigned int totalNegativeCount() const noexcept {
-            return total_alleles_ - set_count_;
+
+        [[nodiscard]] unsigned int totalNegativeCount() const noexcept {
+            return total_alleles_ - alleles_.size();
         }
 
-        constexpr static unsigned int truePositiveCount(const SparseAlleleSet& parent, const SparseAlleleSet& child) noexcept {
-            unsigned int count = 0;
-            for (unsigned int i = 0; i < parent.total_alleles_; ++i) {
-                if (parent.allele(i) && child.allele(i)) {
-                    ++count;
-                }
-            }
-            return count;
+        [[nodiscard]] static unsigned int truePositiveCount(const SparseAlleleSet& parent, const SparseAlleleSet& child) noexcept {
+            return sharedCount(parent, child);
         }
 
-        constexpr static unsigned int trueNegativeCount(const SparseAlleleSet& parent, const SparseAlleleSet& child) noexcept {
-            unsigned int count = 0;
-            for (unsigned int i = 0; i < parent.total_alleles_; ++i) {
-                if (!parent.allele(i) && !child.allele(i)) {
-                    ++count;
-                }
-            }
-            return count;
+        [[nodiscard]] static unsigned int trueNegativeCount(const SparseAlleleSet& parent, const SparseAlleleSet& child) noexcept {
+            return child.total_alleles_ - (parent.alleles_.size() + child.alleles_.size() - sharedCount(parent, child));
         }
 
-        constexpr static unsigned int falsePositiveCount(const SparseAlleleSet& parent, const SparseAlleleSet& child) noexcept {
-            unsigned int count = 0;
-            for (unsigned int i = 0; i < parent.total_alleles_; ++i) {
-                if (!parent.allele(i) && child.allele(i)) {
-                    ++count;
-                }
-            }
-            return count;
+        [[nodiscard]] static unsigned int falsePositiveCount(const SparseAlleleSet& parent, const SparseAlleleSet& child) noexcept {
+            return child.alleles_.size() - sharedCount(parent, child);
         }
 
-        constexpr static unsigned int falseNegativeCount(const SparseAlleleSet& parent, const SparseAlleleSet& child) noexcept {
-            unsigned int count = 0;
-            for (unsigned int i = 0; i < parent.total_alleles_; ++i) {
-                if (parent.allele(i) && !child.allele(i)) {
-                    ++count;
-                }
-            }
-            return count;
+        [[nodiscard]] static unsigned int falseNegativeCount(const SparseAlleleSet& parent, const SparseAlleleSet& child) noexcept {
+            return parent.alleles_.size() - sharedCount(parent, child);
         }
 
-        constexpr static SparseAlleleSet shared(const SparseAlleleSet& lhs, const SparseAlleleSet& rhs) noexcept {
-            unsigned char total_alleles_ = std::min(lhs.total_alleles_, rhs.total_alleles_);
-            unsigned char set_count_ = 0;
-            std::array<unsigned char, MAX_SIZE> set_positions_{};
-            for (unsigned int i = 0; i < total_alleles_; ++i) {
-                if (lhs.allele(i) && rhs.allele(i)) {
-                    set_positions_[set_count_] = i;
-                    ++set_count_;
-                }
-            }
-            return SparseAlleleSet{total_alleles_, set_positions_};
+        /**
+         * @brief True if every allele present in the child is also present in the parent.
+         */
+        [[nodiscard]] static bool covers(const SparseAlleleSet& parent, const SparseAlleleSet& child) noexcept {
+            return std::includes(parent.alleles_.begin(), parent.alleles_.end(), child.alleles_.begin(), child.alleles_.end());
         }
 
-        constexpr static SparseAlleleSet any(const SparseAlleleSet& lhs, const SparseAlleleSet& rhs) noexcept {
-            unsigned char total_alleles_ = std::max(lhs.total_alleles_, rhs.total_alleles_);
-            unsigned char set_count_ = 0;
-            std::array<unsigned char, MAX_SIZE> set_positions_{};
-            for (unsigned int i = 0; i < lhs.total_alleles_; ++i) {
-                if (lhs.allele(i) || rhs.allele(i)) {
-                    set_positions_[set_count_] = i;
-                    ++set_count_;
-                }
-            }
-            return SparseAlleleSet{total_alleles_, set_positions_};
+        [[nodiscard]] static SparseAlleleSet shared(const SparseAlleleSet& lhs, const SparseAlleleSet& rhs) noexcept {
+            SparseAlleleSet result(lhs.total_alleles_, {});
+            std::set_intersection(lhs.alleles_.begin(), lhs.alleles_.end(), rhs.alleles_.begin(), rhs.alleles_.end(), std::back_inserter(result.alleles_));
+            return result;
         }
 
-        constexpr static SparseAlleleSet diff(const SparseAlleleSet& lhs, const SparseAlleleSet& rhs) noexcept {
-            unsigned char total_alleles_ = lhs.total_alleles_;
-            unsigned char set_count_ = 0;
-            std::array<unsigned char, MAX_SIZE> set_positions_{};
-            for (unsigned int i = 0; i < lhs.total_alleles_; ++i) {
-                if ((lhs.allele(i) &&!rhs.allele(i)) || (!lhs.allele(i) && rhs.allele(i))) {
-                    set_positions_[set_count_] = i;
-                    ++set_count_;
-                }
-            }
-            return SparseAlleleSet{total_alleles_, set_positions_};
+        [[nodiscard]] static SparseAlleleSet any(const SparseAlleleSet& lhs, const SparseAlleleSet& rhs) noexcept {
+            SparseAlleleSet result(lhs.total_alleles_, {});
+            std::set_union(lhs.alleles_.begin(), lhs.alleles_.end(), rhs.alleles_.begin(), rhs.alleles_.end(), std::back_inserter(result.alleles_));
+            return result;
         }
 
-        constexpr static SparseAlleleSet invert(const SparseAlleleSet& alleles) noexcept {
-            unsigned char total_alleles_ = alleles.total_alleles_;
-            unsigned char set_count_ = 0;
-            std::array<unsigned char, MAX_SIZE> set_positions_{};
-            for (unsigned int i = 0; i < alleles.total_alleles_; ++i) {
-                if (!alleles.allele(i)) {
-                    set_positions_[set_count_] = i;
-                    ++set_count_;
-                }
-            }
-            return SparseAlleleSet{total_alleles_, set_positions_};
+        [[nodiscard]] static SparseAlleleSet diff(const SparseAlleleSet& lhs, const SparseAlleleSet& rhs) noexcept {
+            SparseAlleleSet result(lhs.total_alleles_, {});
+            std::set_symmetric_difference(lhs.alleles_.begin(), lhs.alleles_.end(), rhs.alleles_.begin(), rhs.alleles_.end(), std::back_inserter(result.alleles_));
+            return result;
         }
 
+        [[nodiscard]] static SparseAlleleSet invert(const SparseAlleleSet& alleles) noexcept;
+
         [[nodiscard]] std::string allelesStr() const noexcept;
         [[nodiscard]] std::string compactAllelesStr() const noexcept;
 
-        [[nodiscard]] constexpr unsigned int totalAlleles() const noexcept {
+        [[nodiscard]] unsigned int totalAlleles() const noexcept {
             return total_alleles_;
         }
 
-        constexpr void flip(const size_t pos) noexcept {
-            for (unsigned int i = 0; i < set_count_; ++i) {
-                if (set_positions_[i] == pos) {
-                    set_positions_[i] = set_positions_[--set_count_];
-                    return;
-                }
-            }
-
-            set_positions_[set_count_] = pos;
-            ++set_count_;
-            // assert(set_count_ < MAX_SIZE);
+        void flip(size_t pos) noexcept {
+            set(pos, !allele(pos));
         }
-        // void flip(std::vector<unsigned int> pos) noexcept;
 
-        constexpr void set(const size_t pos, const bool val) noexcept {
-            for (unsigned int i = 0; i < set_count_; ++i) {
-                if (set_positions_[i] == pos) {
-                    if (!val) {
-                        set_positions_[i] = set_positions_[--set_count_];
-                    }
-                    return;
-                }
+        void flip(const std::vector<unsigned int>& pos) noexcept {
+            for (const auto p : pos) {
+                flip(p);
             }
+        }
 
-            if (val) {
-                set_positions_[set_count_] = pos;
-                ++set_count_;
-                // assert(set_count_ < MAX_SIZE);
+        void set(size_t pos, bool val = true) noexcept {
+            assert(pos < total_alleles_);
+            const auto it = std::lower_bound(alleles_.begin(), alleles_.end(), pos);
+            const bool present = it != alleles_.end() and *it == pos;
+            if (val and !present) {
+                alleles_.insert(it, static_cast<Allele>(pos));
+            } else if (!val and present) {
+                alleles_.erase(it);
             }
         }
-        // void set() noexcept;
 
-        constexpr void reset(const size_t pos) noexcept {
-            for (unsigned int i = 0; i < set_count_; ++i) {
-                if (set_positions_[i] == pos) {
-                    set_positions_[i] = set_positions_[--set_count_];
-                    break;
-                }
-            }
+        void set() noexcept;
+
+        void reset(size_t pos) noexcept {
+            set(pos, false);
         }
-        constexpr void reset() noexcept {
-            set_count_ = 0;
+
+        void reset() noexcept {
+            alleles_.clear();
         }
 
-        [[nodiscard]] constexpr SparseAlleleSet mutationMask(const SparseAlleleSet& parent) const noexcept {
-            std::array<unsigned char, MAX_SIZE> mask_positions{};
-            unsigned char local_set_count_ = 0;
-            for (const auto pos : set_positions_) {
-                if (!parent.allele(pos)) {
-                    mask_positions[local_set_count_] = pos;
-                    ++local_set_count_;
-                }
-            }
+        [[nodiscard]] SparseAlleleSet mutationMask(const SparseAlleleSet& parent) const noexcept {
+            // The mutation mask gets the alleles that are present in the child but not in the parent
+            SparseAlleleSet result(total_alleles_, {});
+            std::set_difference(alleles_.begin(), alleles_.end(), parent.alleles_.begin(), parent.alleles_.end(), std::back_inserter(result.alleles_));
+            return result;
+        }
 
-            return SparseAlleleSet(total_alleles_, mask_positions);
+        [[nodiscard]] bool allele(size_t pos) const noexcept {
+            assert(pos < total_alleles_);
+            return std::binary_search(alleles_.begin(), alleles_.end(), pos);
         }
 
+        /**
+         * @brief Call f(pos) for each allele present, in increasing order of pos.
+         */
+        template<typename F>
+        void forEachAllele(F&& f) const noexcept {
+            for (const auto pos : alleles_) {
+                f(static_cast<std::size_t>(pos));
+            }
+        }
 
-        [[nodiscard]] constexpr bool allele(const size_t pos) const noexcept {
-            for (unsigned int i = 0; i < set_count_; ++i) {
-                if (set_positions_[i] == pos) {
-                    return true;
+        /**
+         * @brief Call f(pos, other.allele(pos)) for each allele present, in increasing order of pos. The two position
+         * lists are merged, so this costs O(alleles present in either) rather than a search per allele.
+         */
+        template<typename F>
+        void forEachAlleleWith(const SparseAlleleSet& other, F&& f) const noexcept {
+            auto r = other.alleles_.begin();
+            for (const auto pos : alleles_) {
+                while (r != other.alleles_.end() and *r < pos) {
+                    ++r;
                 }
+                f(static_cast<std::size_t>(pos), r != other.alleles_.end() and *r == pos);
             }
-            return false;
         }
 
-
-
     private:
-        unsigned char total_alleles_ = 0;
-        unsigned char set_count_ = 0;
-        unsigned char set_positions_[MAX_SIZE];
-
-        constexpr void updateSetPositionsFromBitString(const std::string& bitstr) {
-        set_count_ = 0;
-        for (unsigned int i = 0; i < bitstr.size(); ++i) {
-            if (bitstr[i] == '1') {
-                set_positions_[set_count_] = i;
-                ++set_count_;
+        SparseAlleleSet(const unsigned int totalAlleles, Alleles alleles) : total_alleles_(totalAlleles), alleles_(std::move(alleles)) {}
+
+        static unsigned int sharedCount(const SparseAlleleSet& lhs, const SparseAlleleSet& rhs) noexcept {
+            unsigned int count = 0;
+            auto l = lhs.alleles_.begin();
+            auto r = rhs.alleles_.begin();
+            while (l != lhs.alleles_.end() and r != rhs.alleles_.end()) {
+                if (*l < *r) {
+                    ++l;
+                } else if (*r < *l) {
+                    ++r;
+                } else {
+                    ++count;
+                    ++l;
+                    ++r;
+                }
             }
+            return count;
         }
-    }
-    };
-}
 
+        unsigned int total_alleles_ = 0;
+        Alleles alleles_{};
+    };
+}// namespace transmission_nets::core::datatypes
 
+template<>
+struct std::hash<transmission_nets::core::datatypes::SparseAlleleSet> {
+    std::size_t operator()(const transmission_nets::core::datatypes::SparseAlleleSet& alleles) const noexcept {
+        return alleles.hash();
+    }
+};
 
 
-#endif //SPARSEALLELESET_H
+#endif//SPARSEALLELESET_H
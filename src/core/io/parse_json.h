@@ -20,6 +20,7 @@
 #include <boost/type.hpp>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 
 namespace transmission_nets::core::io {
     using nlohmann::json;
@@ -64,10 +65,12 @@ namespace transmission_nets::core::io {
 
         std::map<std::string, std::shared_ptr<LocusImpl>> locusMap{};
 
+        // Loci are indexed densely in the order they are declared
+        std::size_t locusIndex = 0;
         for (const auto& loc : input.at(lociKey)) {
             const std::string locus_label = loc.at(locusLabelKey);
             int num_alleles = loc.at(numAllelesKey);
-            locusMap.emplace(locus_label, std::make_shared<containers::Locus>(locus_label, num_alleles));
+            locusMap.emplace(locus_label, std::make_shared<containers::Locus>(locus_label, num_alleles, locusIndex++));
         }
 
         return locusMap;
@@ -171,13 +174,9 @@ namespace transmission_nets::core::io {
             const char idKey[] = "id",
             const char allowedParentsKey[] = "allowed_parents") {
 
-        // std::map<std::shared_ptr<InfectionEvent>, std::vector<std::shared_ptr<InfectionEvent>>> allowedParents{};
-        // std::map<std::shared_ptr<InfectionEvent>, std::vector<std::shared_ptr<InfectionEvent>>> allowedChildren{};
-
-        std::shared_ptr<containers::AllowedRelationships<InfectionEvent>> allowedRelationships = std::make_shared<containers::AllowedRelationships<InfectionEvent>>();
-
-        for (const auto& targetInfection : infections) {
-            allowedRelationships->addInfectionEvent(targetInfection);
+        std::vector<typename containers::AllowedRelationships<InfectionEvent>::Edge> edges{};
+        for (std::size_t targetIdx = 0; targetIdx < infections.size(); ++targetIdx) {
+            const auto& targetInfection = infections[targetIdx];
             for (const auto& inf : input.at(infectionsKey)) {
                 auto infectionId = inf.at(idKey);
                 if (infectionId == targetInfection->id()) {
@@ -188,17 +187,17 @@ namespace transmission_nets::core::io {
                                 [&parentIdStr](const std::shared_ptr<InfectionEvent> candidateInf) {
                                     return candidateInf->id() == parentIdStr;
                                 });
-                        allowedRelationships->addParent(targetInfection, *parentInf);
-                        allowedRelationships->addChild(*parentInf, targetInfection);
-
-                        // allowedRelationships.allowedParents[targetInfection].push_back(*parentInf);
-                        // allowedRelationships.allowedChildren[*parentInf].push_back(targetInfection);
+                        if (parentInf == infections.end()) {
+                            throw std::invalid_argument("Infection " + targetInfection->id() + " has unknown allowed parent " + parentIdStr);
+                        }
+                        edges.emplace_back(targetIdx, static_cast<std::size_t>(std::distance(infections.begin(), parentInf)));
                     }
                     break;
                 }
             }
         }
 
+        auto allowedRelationships = std::make_shared<containers::AllowedRelationships<InfectionEvent>>(std::move(infections), edges);
         return allowedRelationships;
     }
 }// namespace transmission_nets::core::io
@@ -10,6 +10,7 @@
 
 #include <iostream>
 #include <memory>
+#include <span>
 #include <vector>
 
 
@@ -18,10 +19,13 @@ namespace transmission_nets::core::parameters {
     class Ordering : public Parameter<std::vector<std::shared_ptr<T>>> {
 
         using MovedCallback = std::function<void(std::shared_ptr<T> element)>;
+        using MovedPastCallback = std::function<void(std::span<const std::shared_ptr<T>> elements)>;
         using ChangedCallback = std::function<void(std::shared_ptr<T> element)>;
         CREATE_KEYED_EVENT(moved_left, std::shared_ptr<T>, MovedCallback) // Notifies that an element has been moved left of key
         CREATE_KEYED_EVENT(moved_right, std::shared_ptr<T>, MovedCallback)// Notifies that an element has been moved right of key
-        CREATE_EVENT(element_changed, ChangedCallback);
+        CREATE_KEYED_EVENT(moved_left_past, std::shared_ptr<T>, MovedPastCallback) // Notifies that key has been moved left of all elements
+        CREATE_KEYED_EVENT(moved_right_past, std::shared_ptr<T>, MovedPastCallback)// Notifies that key has been moved right of all elements
+        CREATE_KEYED_EVENT(element_changed, std::shared_ptr<T>, ChangedCallback)// Notifies listeners of key that it has changed
 
 
     public:
@@ -35,6 +39,13 @@ namespace transmission_nets::core::parameters {
 
         void addElements(const std::vector<std::shared_ptr<T>>& refs) noexcept;
 
+        /**
+         * @brief The current ordering as a span. The view is invalidated when the ordering changes.
+         */
+        std::span<const std::shared_ptr<T>> view() const noexcept {
+            return this->value_;
+        }
+
         friend std::ostream& operator<<(std::ostream& os, const Ordering& list) noexcept {
             for (unsigned long i = 0; i < list.value_.size(); ++i) {
                 os << "Element " << i << ": " << *list.value_[i] << "\n";
@@ -60,6 +71,7 @@ namespace transmission_nets::core::parameters {
     void Ordering<T>::swap(int a, int b) noexcept {
         if (a != b) {
             this->notify_pre_change();
+            this->checkpointBeforeChange();
             auto tmp           = this->value_.at(a);
             this->value_.at(a) = this->value_.at(b);
             this->value_.at(b) = tmp;
@@ -76,9 +88,13 @@ namespace transmission_nets::core::parameters {
     template<typename T>
     void Ordering<T>::addElement(std::shared_ptr<T> ref) noexcept {
         this->notify_pre_change();
+        this->checkpointBeforeChange();
         this->value_.push_back(ref);
         register_moved_left_listener_key(ref);
         register_moved_right_listener_key(ref);
+        register_moved_left_past_listener_key(ref);
+        register_moved_right_past_listener_key(ref);
+        register_element_changed_listener_key(ref);
         this->notify_post_change();
     }
 
@@ -91,27 +107,25 @@ namespace transmission_nets::core::parameters {
 
     template<typename T>
     void Ordering<T>::notifySwap(const int left_idx, const int right_idx) noexcept {
-        keyed_notify_moved_right(this->value_[left_idx], this->value_[right_idx]);
-        keyed_notify_moved_left(this->value_[right_idx], this->value_[left_idx]);
+        const auto& movedLeft  = this->value_[left_idx];
+        const auto& movedRight = this->value_[right_idx];
         for (int i = left_idx + 1; i < right_idx; ++i) {
-
-            // value_[i] has been moved left of element at value_[right_idx]
-            keyed_notify_moved_left(this->value_[right_idx], this->value_[i]);
-
             // value_[right_idx] has been moved right of element at value_[i]
-            keyed_notify_moved_right(this->value_[i], this->value_[right_idx]);
-
-            // value_[i] has been moved right of element at value_[left_idx]
-            keyed_notify_moved_right(this->value_[left_idx], this->value_[i]);
+            keyed_notify_moved_right(this->value_[i], movedRight);
 
             // value_[left_idx] has been moved left of element at value_[i]
-            keyed_notify_moved_left(this->value_[i], this->value_[left_idx]);
+            keyed_notify_moved_left(this->value_[i], movedLeft);
         }
+
+        // Each of the swapped elements has been moved past everything between them and past the other
+        const std::span<const std::shared_ptr<T>> ordering(this->value_);
+        keyed_notify_moved_right_past(movedRight, ordering.subspan(left_idx, right_idx - left_idx));
+        keyed_notify_moved_left_past(movedLeft, ordering.subspan(left_idx + 1, right_idx - left_idx));
     }
 
     template<typename T>
     void Ordering<T>::elementChanged(std::shared_ptr<T> ref) noexcept {
-        this->notify_element_changed(ref);
+        keyed_notify_element_changed(ref, ref);
         this->setDirty();
     }
 
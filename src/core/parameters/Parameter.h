@@ -20,6 +20,9 @@ namespace transmission_nets::core::parameters {
                       public abstract::Checkpointable<Parameter<T>, T> {
 
     public:
+        // Checkpoints copy the value only when it changes, every change to value_ must call checkpointBeforeChange first
+        static constexpr bool deferCheckpoints = true;
+
         template<typename Args, ENABLE_IF(core::utils::NonSelf<Args, Parameter>())>
         explicit Parameter(Args&& args) : value_(std::forward<Args>(args)) {}
 
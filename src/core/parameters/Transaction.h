@@ -0,0 +1,129 @@
+#ifndef TRANSMISSION_NETWORKS_APP_TRANSACTION_H
+#define TRANSMISSION_NETWORKS_APP_TRANSACTION_H
+
+#include "core/abstract/observables/Cacheable.h"
+#include "core/containers/OpenAddressingMap.h"
+#include "core/parameters/Parameter.h"
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace transmission_nets::core::parameters {
+
+    /*
+     * Changes to several parameters proposed together. Each parameter is saved the first time it is changed and its
+     * listeners are held back until commit, which notifies post_change once per changed parameter, in the order the
+     * parameters were first changed. Setting a parameter to the value it already holds is not a change, so a proposal
+     * that leaves most of its parameters alone only invalidates what depends on the rest. The notifications run in one
+     * abstract::DirtyBatch, so a dependent shared by several changed parameters invalidates its own dependents once.
+     *
+     * After commit the group must be resolved as a unit with accept or restore before the transaction is destroyed.
+     */
+    class Transaction {
+    public:
+        explicit Transaction(const int savedStateId) noexcept : savedStateId_(savedStateId) {}
+
+        Transaction(const Transaction&)            = delete;
+        Transaction& operator=(const Transaction&) = delete;
+
+        ~Transaction() {
+            assert(resolved_);
+        }
+
+        template<typename T>
+        void set(Parameter<T>& parameter, const T& value) noexcept;
+
+        /**
+         * @brief Notify the listeners of every changed parameter.
+         */
+        void commit() noexcept {
+            assert(!committed_);
+            committed_ = true;
+            abstract::DirtyBatch batch;
+            for (const auto& entry : entries_) {
+                entry.notify(entry.parameter);
+            }
+        }
+
+        void accept() noexcept {
+            assert(committed_ and !resolved_);
+            resolved_ = true;
+            for (const auto& entry : entries_) {
+                entry.accept(entry.parameter);
+            }
+            entries_.clear();
+            changed_.clear();
+        }
+
+        void restore() noexcept {
+            assert(committed_ and !resolved_);
+            resolved_ = true;
+            for (const auto& entry : entries_) {
+                entry.restore(entry.parameter, savedStateId_);
+            }
+            entries_.clear();
+            changed_.clear();
+        }
+
+        /**
+         * @brief Number of parameters changed by the transaction.
+         */
+        [[nodiscard]] std::size_t size() const noexcept {
+            return entries_.size();
+        }
+
+    private:
+        // Type erased operations on a changed parameter
+        struct Entry {
+            void* parameter;
+            void (*notify)(void*);
+            void (*accept)(void*);
+            void (*restore)(void*, int);
+        };
+
+        template<typename T>
+        static Entry makeEntry(Parameter<T>& parameter) noexcept {
+            return {
+                    &parameter,
+                    [](void* p) { static_cast<Parameter<T>*>(p)->notify_post_change(); },
+                    [](void* p) { static_cast<Parameter<T>*>(p)->acceptState(); },
+                    [](void* p, const int savedStateId) { static_cast<Parameter<T>*>(p)->restoreState(savedStateId); }};
+        }
+
+        static containers::OpenAddressingMap<bool>::key_type keyOf(const void* parameter) noexcept {
+            return reinterpret_cast<std::uintptr_t>(parameter);
+        }
+
+        int savedStateId_;
+        bool committed_ = false;
+        bool resolved_  = false;
+        std::vector<Entry> entries_{};
+        // Parameters in entries_, so each set is one probe however many parameters the transaction changes
+        containers::OpenAddressingMap<bool> changed_{};
+    };
+
+    template<typename T>
+    void Transaction::set(Parameter<T>& parameter, const T& value) noexcept {
+        assert(!committed_);
+        if (changed_.find(keyOf(&parameter)) == changed_.end()) {
+            if constexpr (std::equality_comparable<T>) {
+                if (parameter.value() == value) {
+                    return;
+                }
+            }
+            parameter.saveState(savedStateId_);
+            parameter.notify_pre_change();
+            entries_.push_back(makeEntry(parameter));
+            changed_.insert_or_assign(keyOf(&parameter), true);
+        }
+        parameter.stageValue(value);
+    }
+
+}// namespace transmission_nets::core::parameters
+
+
+#endif//TRANSMISSION_NETWORKS_APP_TRANSACTION_H
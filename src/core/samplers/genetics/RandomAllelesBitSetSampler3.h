@@ -7,8 +7,9 @@
 
 #include <boost/random.hpp>
 
+#include "core/parameters/Transaction.h"
 #include "core/samplers/AbstractSampler.h"
-#include "core/utils/generators/CombinationIndicesGenerator.h"
+#include "core/utils/generators/FixedCombinationIndicesGenerator.h"
 #include "core/utils/numerics.h"
 
 #include <memory>
@@ -62,7 +63,7 @@ namespace transmission_nets::core::samplers::genetics {
     void RandomAllelesBitSetSampler3<T, Engine, InfectionEventImpl, GeneticsImpl, ParentSetImpl, MaxParentSetSize, MaxCOI>::update() noexcept {
         SAMPLER_STATE_ID stateId = RandomAlleleBitSet3ID;
 
-        utils::generators::CombinationIndicesGenerator ps_idx_gen;
+        utils::generators::FixedCombinationIndicesGenerator<MaxParentSetSize> ps_idx_gen;
 
         int total_possible_parent_sets = 0;
         std::vector<int> cumulative_possible_parent_set_sizes{};
@@ -80,7 +81,7 @@ namespace transmission_nets::core::samplers::genetics {
         }
 
         bool include_latent_parent = false;
-        std::vector<unsigned int> parent_set_idxs{};
+        std::span<const unsigned int> parent_set_idxs{};
 
         if (total_possible_parent_sets > 0) {
             parent_set_sampling_dist.param(boost::random::uniform_int_distribution<>::param_type(0, total_possible_parent_sets - 1));
@@ -95,7 +96,7 @@ namespace transmission_nets::core::samplers::genetics {
                     break;
                 }
             }
-            parent_set_idxs = ps_idx_gen.curr;
+            parent_set_idxs = ps_idx_gen.curr();
 
         } else {
             // if there are no possible parent sets, then the latent parent must be included
@@ -103,8 +104,8 @@ namespace transmission_nets::core::samplers::genetics {
         }
 
         // Sample a new proposed genetic state with at least one coming from each parent
+        core::parameters::Transaction transaction(stateId);
         for (const auto& locus : infection_->loci()) {
-            infection_->latentGenotype(locus)->saveState(stateId);
             auto proposal = infection_->latentGenotype(locus)->value();
             proposal.reset();
 
@@ -117,7 +118,7 @@ namespace transmission_nets::core::samplers::genetics {
                         all_shared = GeneticsImpl::any(all_shared, tmp_ps.begin()[parent_set_idxs[i]]->latentGenotype(locus)->value());
                     }
                 } else {
-                    for (unsigned int& parent_set_idx : parent_set_idxs) {
+                    for (const unsigned int parent_set_idx : parent_set_idxs) {
                         all_shared = GeneticsImpl::any(all_shared, tmp_ps.begin()[parent_set_idx]->latentGenotype(locus)->value());
                     }
                 }
@@ -184,7 +185,7 @@ namespace transmission_nets::core::samplers::genetics {
                         }
                     }
                 }
-                infection_->latentGenotype(locus)->setValue(proposal);
+                transaction.set(*infection_->latentGenotype(locus), proposal);
             } else {
                 // if the locus is not observed, then sample a new allele for each allele in the parent set
                 for (const auto& i : rand_seq) {
@@ -214,10 +215,12 @@ namespace transmission_nets::core::samplers::genetics {
                         }
                     }
                 }
-                infection_->latentGenotype(locus)->setValue(proposal);
+                transaction.set(*infection_->latentGenotype(locus), proposal);
             }
         }
 
+        transaction.commit();
+
         Likelihood proposed_state_prob = calculateSamplingProb();
 
         const auto acceptanceRatio = target_->value() - cur_lik + current_state_prob - proposed_state_prob;
@@ -238,14 +241,10 @@ namespace transmission_nets::core::samplers::genetics {
 
         if (accept) {
             acceptances_++;
-            for (const auto& locus : infection_->loci()) {
-                infection_->latentGenotype(locus)->acceptState();
-            }
+            transaction.accept();
         } else {
             rejections_++;
-            for (const auto& locus : infection_->loci()) {
-                infection_->latentGenotype(locus)->restoreState(stateId);
-            }
+            transaction.restore();
         }
 
         if (debug_) {
@@ -277,9 +276,9 @@ namespace transmission_nets::core::samplers::genetics {
         //  requiring every parent to propagate at least one allele
         // iterate over all possible parent sets
         for (size_t num_parents = 1; num_parents <= MaxParentSetSize and num_parents <= total_parents; ++num_parents) {
-            core::utils::generators::CombinationIndicesGenerator psIdxGen(total_parents, num_parents);
+            core::utils::generators::FixedCombinationIndicesGenerator<MaxParentSetSize> psIdxGen(total_parents, num_parents);
 
-            const auto& parent_set_idxs = psIdxGen.curr;
+            const auto parent_set_idxs = psIdxGen.curr();
             // iterate over all possible parent sets of size num_parents
             while (!psIdxGen.completed) {
 
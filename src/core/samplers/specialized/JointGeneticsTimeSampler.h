@@ -11,8 +11,9 @@
 
 #include "core/datatypes/Alleles.h"
 #include "core/parameters/Parameter.h"
+#include "core/parameters/Transaction.h"
 #include "core/samplers/AbstractSampler.h"
-#include "core/utils/generators/CombinationIndicesGenerator.h"
+#include "core/utils/generators/FixedCombinationIndicesGenerator.h"
 #include "core/utils/generators/RandomSequence.h"
 #include "core/utils/numerics.h"
 
@@ -99,7 +100,7 @@ namespace transmission_nets::core::samplers::specialized {
     template<typename T, typename Engine, typename InfectionEventImpl, typename GeneticsImpl, typename ParentSetImpl, int MaxParentSetSize, int MaxCOI>
     void JointGeneticsTimeSampler<T, Engine, InfectionEventImpl, GeneticsImpl, ParentSetImpl, MaxParentSetSize, MaxCOI>::update() noexcept {
         SAMPLER_STATE_ID stateId = SAMPLER_STATE_ID::JointGeneticsTimeID;
-        core::utils::generators::CombinationIndicesGenerator ps_idx_gen;
+        core::utils::generators::FixedCombinationIndicesGenerator<MaxParentSetSize> ps_idx_gen;
 
         int total_possible_parent_sets = 0;
         std::vector<int> cumulative_possible_parent_set_sizes{};
@@ -112,7 +113,7 @@ namespace transmission_nets::core::samplers::specialized {
 
         // update infection time
         double cur_infection_time = infection_duration_->value();
-        infection_duration_->saveState(stateId);
+        core::parameters::Transaction transaction(stateId);
 
         const double eps           = normal_dist_(*rng_) * variance_;
         const double unconstrained = std::log(cur_infection_time - lower_bound_) - std::log(upper_bound_ - cur_infection_time);
@@ -124,7 +125,7 @@ namespace transmission_nets::core::samplers::specialized {
                    log(cur_infection_time - lower_bound_) -
                    log(upper_bound_ - cur_infection_time);
 
-        infection_duration_->setValue(proposed_infection_time);
+        transaction.set(*infection_duration_, proposed_infection_time);
 
         // Calculate the total number of possible parent sets across possible parent set sizes
         for (size_t i = 1; i <= MaxParentSetSize and i <= tmp_ps.size(); ++i) {
@@ -133,7 +134,7 @@ namespace transmission_nets::core::samplers::specialized {
         }
 
         bool include_latent_parent = false;
-        std::vector<unsigned int> parent_set_idxs{};
+        std::span<const unsigned int> parent_set_idxs{};
 
         if (total_possible_parent_sets > 0) {
             parent_set_sampling_dist.param(boost::random::uniform_int_distribution<>::param_type(0, total_possible_parent_sets - 1));
@@ -148,7 +149,7 @@ namespace transmission_nets::core::samplers::specialized {
                     break;
                 }
             }
-            parent_set_idxs = ps_idx_gen.curr;
+            parent_set_idxs = ps_idx_gen.curr();
 
         } else {
             // if there are no possible parent sets, then the latent parent must be included
@@ -157,7 +158,6 @@ namespace transmission_nets::core::samplers::specialized {
 
         // Sample a new proposed genetic state with at least one coming from each parent
         for (const auto& locus : infection_->loci()) {
-            infection_->latentGenotype(locus)->saveState(stateId);
             auto proposal = infection_->latentGenotype(locus)->value();
             proposal.reset();
 
@@ -170,7 +170,7 @@ namespace transmission_nets::core::samplers::specialized {
                         all_shared = GeneticsImpl::any(all_shared, tmp_ps.begin()[parent_set_idxs[i]]->latentGenotype(locus)->value());
                     }
                 } else {
-                    for (unsigned int& parent_set_idx : parent_set_idxs) {
+                    for (const unsigned int parent_set_idx : parent_set_idxs) {
                         all_shared = GeneticsImpl::any(all_shared, tmp_ps.begin()[parent_set_idx]->latentGenotype(locus)->value());
                     }
                 }
@@ -235,7 +235,7 @@ namespace transmission_nets::core::samplers::specialized {
                         }
                     }
                 }
-                infection_->latentGenotype(locus)->setValue(proposal);
+                transaction.set(*infection_->latentGenotype(locus), proposal);
             } else {
                 // if the locus is not observed, then sample a new allele for each allele in the parent set
                 for (const auto& i : rand_seq) {
@@ -265,10 +265,12 @@ namespace transmission_nets::core::samplers::specialized {
                         }
                     }
                 }
-                infection_->latentGenotype(locus)->setValue(proposal);
+                transaction.set(*infection_->latentGenotype(locus), proposal);
             }
         }
 
+        transaction.commit();
+
         Likelihood proposed_state_prob = calculateSamplingProb();
 
         const auto acceptanceRatio = target_->value() - cur_lik + current_state_prob - proposed_state_prob + adj;
@@ -285,17 +287,10 @@ namespace transmission_nets::core::samplers::specialized {
 
         if (accept) {
             acceptances_++;
-
-            infection_duration_->acceptState();
-            for (const auto& locus : infection_->loci()) {
-                infection_->latentGenotype(locus)->acceptState();
-            }
+            transaction.accept();
         } else {
             rejections_++;
-            infection_duration_->restoreState(stateId);
-            for (const auto& locus : infection_->loci()) {
-                infection_->latentGenotype(locus)->restoreState(stateId);
-            }
+            transaction.restore();
         }
 
         assert(!target_->isDirty());
@@ -322,9 +317,9 @@ namespace transmission_nets::core::samplers::specialized {
         //  requiring every parent to propagate at least one allele
         // iterate over all possible parent sets
         for (size_t num_parents = 1; num_parents <= MaxParentSetSize and num_parents <= total_parents; ++num_parents) {
-            core::utils::generators::CombinationIndicesGenerator psIdxGen(total_parents, num_parents);
+            core::utils::generators::FixedCombinationIndicesGenerator<MaxParentSetSize> psIdxGen(total_parents, num_parents);
 
-            const auto& parent_set_idxs = psIdxGen.curr;
+            const auto parent_set_idxs = psIdxGen.curr();
             // iterate over all possible parent sets of size num_parents
             while(!psIdxGen.completed) {
 
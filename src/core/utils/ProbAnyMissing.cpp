@@ -5,7 +5,204 @@
 
 #include "ProbAnyMissing.h"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <utility>
+
+// Architecture-specific intrinsics (x86/x64 only)
+#if defined(__x86_64__) || defined(__i386__)
+#define TRANSMISSION_NETWORKS_X86_KERNELS
+#include <immintrin.h>
+#endif
+
 namespace transmission_nets::core::utils {
+
+    namespace {
+        /*
+         * Each kernel advances the signed powers of the bases one trial at a time and writes the sum over subsets
+         * to out[j] for every trial j >= first. Sums are independent across trials, the vector units are used across subsets.
+         *
+         * All kernels sum in the same order, so they agree to the last bit: term t goes to partial sum t % reductionWidth
+         * for every full block of reductionWidth terms, the partial sums are reduced pairwise by reducePartials, and the
+         * remaining terms are added one at a time. The AVX512 kernel holds the partial sums in one register and the AVX2
+         * kernel in two.
+         */
+        constexpr std::size_t reductionWidth = 8;
+
+        // Partial sums p0 ... p7 are reduced as ((p0 + p4) + (p2 + p6)) + ((p1 + p5) + (p3 + p7))
+        Likelihood reducePartials(const Likelihood* partials) {
+            Likelihood quarter[4];
+            for (std::size_t i = 0; i < 4; ++i) {
+                quarter[i] = partials[i] + partials[i + 4];
+            }
+            return (quarter[0] + quarter[2]) + (quarter[1] + quarter[3]);
+        }
+
+        void accumulateScalar(const Likelihood* bases, Likelihood* powers, const std::size_t totalTerms, const std::size_t first, const unsigned int numEvents, Likelihood* out) {
+            for (std::size_t j = 0; j < numEvents; ++j) {
+                for (std::size_t t = 0; t < totalTerms; ++t) {
+                    powers[t] *= bases[t];
+                }
+                Likelihood partials[reductionWidth]{};
+                std::size_t t = 0;
+                for (; t + reductionWidth <= totalTerms; t += reductionWidth) {
+                    for (std::size_t lane = 0; lane < reductionWidth; ++lane) {
+                        partials[lane] += powers[t + lane];
+                    }
+                }
+                Likelihood sum = reducePartials(partials);
+                for (; t < totalTerms; ++t) {
+                    sum += powers[t];
+                }
+                if (j >= first) {
+                    out[j] = sum;
+                }
+            }
+        }
+
+#ifdef TRANSMISSION_NETWORKS_X86_KERNELS
+        // Reduces the partial sums of lanes 0 ... 3 and 4 ... 7 in the order of reducePartials
+        __attribute__((target("avx2"))) inline Likelihood reduceAVX2(const __m256d low, const __m256d high) {
+            const __m256d quarter = _mm256_add_pd(low, high);
+            const __m128d half    = _mm_add_pd(_mm256_castpd256_pd128(quarter), _mm256_extractf128_pd(quarter, 1));
+            return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+        }
+
+        __attribute__((target("avx2"))) void accumulateAVX2(const Likelihood* bases, Likelihood* powers, const std::size_t totalTerms, const std::size_t first, const unsigned int numEvents, Likelihood* out) {
+            for (std::size_t j = 0; j < numEvents; ++j) {
+                __m256d low  = _mm256_setzero_pd();
+                __m256d high = _mm256_setzero_pd();
+                std::size_t t = 0;
+                for (; t + reductionWidth <= totalTerms; t += reductionWidth) {
+                    const __m256d pLow  = _mm256_mul_pd(_mm256_loadu_pd(powers + t), _mm256_loadu_pd(bases + t));
+                    const __m256d pHigh = _mm256_mul_pd(_mm256_loadu_pd(powers + t + 4), _mm256_loadu_pd(bases + t + 4));
+                    _mm256_storeu_pd(powers + t, pLow);
+                    _mm256_storeu_pd(powers + t + 4, pHigh);
+                    low  = _mm256_add_pd(low, pLow);
+                    high = _mm256_add_pd(high, pHigh);
+                }
+                Likelihood sum = reduceAVX2(low, high);
+                for (; t < totalTerms; ++t) {
+                    powers[t] *= bases[t];
+                    sum += powers[t];
+                }
+                if (j >= first) {
+                    out[j] = sum;
+                }
+            }
+        }
+
+        __attribute__((target("avx512f"))) void accumulateAVX512(const Likelihood* bases, Likelihood* powers, const std::size_t totalTerms, const std::size_t first, const unsigned int numEvents, Likelihood* out) {
+            for (std::size_t j = 0; j < numEvents; ++j) {
+                __m512d acc  = _mm512_setzero_pd();
+                std::size_t t = 0;
+                for (; t + reductionWidth <= totalTerms; t += reductionWidth) {
+                    const __m512d p = _mm512_mul_pd(_mm512_loadu_pd(powers + t), _mm512_loadu_pd(bases + t));
+                    _mm512_storeu_pd(powers + t, p);
+                    acc = _mm512_add_pd(acc, p);
+                }
+                // _mm512_reduce_add_pd does not fix its order, reduce the two halves as the AVX2 kernel does
+                const __m256d quarter = _mm256_add_pd(_mm512_castpd512_pd256(acc), _mm512_extractf64x4_pd(acc, 1));
+                const __m128d half    = _mm_add_pd(_mm256_castpd256_pd128(quarter), _mm256_extractf128_pd(quarter, 1));
+                Likelihood sum        = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+                for (; t < totalTerms; ++t) {
+                    powers[t] *= bases[t];
+                    sum += powers[t];
+                }
+                if (j >= first) {
+                    out[j] = sum;
+                }
+            }
+        }
+#endif
+
+        /*
+         * Fully unrolled inclusion-exclusion for K events. The number of subsets and their signs are known at compile time,
+         * so each trial is a fixed sequence of multiplies and adds without any loop or subset bookkeeping.
+         */
+        template<std::size_t K>
+        void pamSmall(const Likelihood* eventProbs, const unsigned int numEvents, Likelihood* out) {
+            constexpr std::size_t totalTerms = (std::size_t{1} << K) - 1;
+            std::array<Likelihood, totalTerms> bases{};
+            std::array<Likelihood, totalTerms> powers{};
+            for (std::size_t t = 0; t < totalTerms; ++t) {
+                Likelihood subsetProb = 0.0;
+                for (std::size_t e = 0; e < K; ++e) {
+                    if (((t + 1) >> e) & 1) {
+                        subsetProb += eventProbs[e];
+                    }
+                }
+                bases[t]  = 1.0 - subsetProb;
+                powers[t] = std::popcount(t + 1) & 1 ? 1.0 : -1.0;
+            }
+
+            const auto step = [&]<std::size_t... t>(std::index_sequence<t...>) __attribute__((always_inline)) {
+                ((powers[t] *= bases[t]), ...);
+                return (powers[t] + ...);
+            };
+
+            std::fill_n(out, K - 1, 1.0);
+            for (unsigned int j = 0; j < K - 1; ++j) {
+                step(std::make_index_sequence<totalTerms>{});
+            }
+            for (unsigned int j = K - 1; j < numEvents; ++j) {
+                out[j] = step(std::make_index_sequence<totalTerms>{});
+            }
+        }
+    }// namespace
+
+    bool probAnyMissingFunctor::supported(const Kernel kernel) noexcept {
+        switch (kernel) {
+            case Kernel::Scalar:
+                return true;
+#ifdef TRANSMISSION_NETWORKS_X86_KERNELS
+            case Kernel::AVX2:
+                return __builtin_cpu_supports("avx2");
+            case Kernel::AVX512:
+                return __builtin_cpu_supports("avx512f");
+#endif
+            default:
+                return false;
+        }
+    }
+
+    probAnyMissingFunctor::Kernel probAnyMissingFunctor::bestKernel() noexcept {
+        static const Kernel best = [] {
+            if (supported(Kernel::AVX512)) {
+                return Kernel::AVX512;
+            }
+            if (supported(Kernel::AVX2)) {
+                return Kernel::AVX2;
+            }
+            return Kernel::Scalar;
+        }();
+        return best;
+    }
+
+    /**
+     * Sum the probabilities of each non-empty subset of events, indexed by the bitmask of the subset less one. Each sum
+     * extends the sum of the subset without its lowest event, sum[mask] = sum[mask & (mask - 1)] + p[ctz(mask)], so it is
+     * built from at most totalEvents - 1 additions and does not depend on the subsets enumerated before it. powVec is
+     * initialized to the inclusion-exclusion sign of each subset.
+     */
+    void probAnyMissingFunctor::subsetBases(const Likelihood* eventProbs, const std::size_t totalEvents) {
+        assert(totalEvents < 32);
+        const std::size_t totalTerms = (std::size_t{1} << totalEvents) - 1;
+        baseVec.resize(totalTerms);
+        powVec.resize(totalTerms);
+
+        for (std::size_t mask = 1; mask <= totalTerms; ++mask) {
+            const std::size_t rest = mask & (mask - 1);
+            baseVec[mask - 1]      = (rest == 0 ? 0.0 : baseVec[rest - 1]) + eventProbs[std::countr_zero(mask)];
+        }
+        for (std::size_t mask = 1; mask <= totalTerms; ++mask) {
+            baseVec[mask - 1] = 1.0 - baseVec[mask - 1];
+            powVec[mask - 1]  = std::popcount(mask) & 1 ? 1.0 : -1.0;
+        }
+    }
+
     /**
      * Calculate the probability that one or more events never occur over a sequence of trials
      * @param eventProbs Vector of probabilities of event A_1 ... A_n
@@ -20,158 +217,83 @@ namespace transmission_nets::core::utils {
             return 1.0;
         }
 
-        Likelihood prob = 0.0;
-
         //      Calculate via inclusion-exclusion principle
-        int sign = -1;
-        for (std::size_t i = 1; i <= totalEvents; ++i) {
-            sign = -sign;
-            c.reset(totalEvents, i);
-            baseVec.resize(0);
-            while (!c.completed) {
-                Likelihood base = 1.0;
-
-                for (const auto j : c.curr) {
-                    base -= eventProbs[j];
-                }
-                baseVec.push_back(base);
-                c.next();
-            }
-
-            for (const Likelihood j : baseVec) {
-                Likelihood base = j;
-                Likelihood r = sign;
-                int multCounter = static_cast<signed>(numEvents);
-                // squared exponentiation
-                while (multCounter > 0) {
-                    if (multCounter & 1) {
-                        r *= base;
-                    }
-                    base = (base * base);
-                    multCounter >>= 1;
+        subsetBases(eventProbs.data(), totalEvents);
+        Likelihood prob = 0.0;
+        for (std::size_t t = 0; t < baseVec.size(); ++t) {
+            Likelihood base = baseVec[t];
+            Likelihood r    = powVec[t];
+            int multCounter = static_cast<signed>(numEvents);
+            // squared exponentiation
+            while (multCounter > 0) {
+                if (multCounter & 1) {
+                    r *= base;
                 }
-                prob += r;
+                base = (base * base);
+                multCounter >>= 1;
             }
+            prob += r;
         }
         return prob;
     }
 
     std::vector<Likelihood> probAnyMissingFunctor::vectorized(const std::vector<Likelihood>& eventProbs, unsigned int numEvents) {
-        const std::size_t totalEvents = eventProbs.size();
-
         std::vector<Likelihood> probVec(numEvents, 0.0);
+        vectorized(eventProbs.data(), eventProbs.size(), numEvents, probVec.data());
+        return probVec;
+    }
+
+    void probAnyMissingFunctor::vectorized(const Likelihood* eventProbs, std::size_t totalEvents, unsigned int numEvents, Likelihood* out) {
+        if (numEvents >= totalEvents and totalEvents <= maxUnrolledEvents) {
+            switch (totalEvents) {
+                case 1:
+                    pamSmall<1>(eventProbs, numEvents, out);
+                    return;
+                case 2:
+                    pamSmall<2>(eventProbs, numEvents, out);
+                    return;
+                case 3:
+                    pamSmall<3>(eventProbs, numEvents, out);
+                    return;
+                case 4:
+                    pamSmall<4>(eventProbs, numEvents, out);
+                    return;
+                default:
+                    break;
+            }
+        }
+        vectorized(eventProbs, totalEvents, numEvents, out, bestKernel());
+    }
 
+    void probAnyMissingFunctor::vectorized(const Likelihood* eventProbs, std::size_t totalEvents, unsigned int numEvents, Likelihood* out, const Kernel kernel) {
         if (numEvents < totalEvents) {
-            std::fill_n(probVec.begin(), numEvents, 1.0);
-            return probVec;
+            std::fill_n(out, numEvents, 1.0);
+            return;
         }
 
-        std::fill_n(probVec.begin(), totalEvents - 1, 1.0);
+        std::fill_n(out, numEvents, 0.0);
+        if (totalEvents == 0) {
+            return;
+        }
+        // All events cannot occur in fewer trials than there are events
+        std::fill_n(out, totalEvents - 1, 1.0);
 
         //      Calculate via inclusion-exclusion principle
-        double sign = -1.0;
-        for (std::size_t i = 1; i <= totalEvents; ++i) {
-            sign = -sign;
-            c.reset(totalEvents, i);
-            baseVec.clear();
-            baseVec.reserve(c.numCombinations);
-            while (!c.completed) {
-                Likelihood base = 1.0;
-
-                for (const auto j : c.curr) {
-                    base -= eventProbs[j];
-                }
-                baseVec.push_back(base);
-                c.next();
-            }
-
-            for (const Likelihood base : baseVec) {
-                Likelihood r = sign;
-                for (std::size_t j = 0; j < totalEvents - 1; ++j) {
-                    r *= base;
-                }
-
-                for (std::size_t j = totalEvents - 1; j < numEvents; ++j) {
-                    r *= base;
-                    probVec[j] += r;
-                }
-            }
+        subsetBases(eventProbs, totalEvents);
+        const std::size_t first = totalEvents - 1;
+        switch (supported(kernel) ? kernel : Kernel::Scalar) {
+#ifdef TRANSMISSION_NETWORKS_X86_KERNELS
+            case Kernel::AVX512:
+                accumulateAVX512(baseVec.data(), powVec.data(), baseVec.size(), first, numEvents, out);
+                break;
+            case Kernel::AVX2:
+                accumulateAVX2(baseVec.data(), powVec.data(), baseVec.size(), first, numEvents, out);
+                break;
+#endif
+            default:
+                accumulateScalar(baseVec.data(), powVec.data(), baseVec.size(), first, numEvents, out);
+                break;
         }
-        return probVec;
     }
 
-
-    //
-    // Likelihood transmission_nets::core::utils::probAnyMissingFunctor::simd(const std::vector<Likelihood>& eventProbs, unsigned int numEvents) {
-    //     std::size_t totalEvents = eventProbs.size();
-    //     int multCounter;
-    //     Likelihood r;
-    //
-    //     if (numEvents < totalEvents) {
-    //         return 0.0;
-    //     }
-    //
-    //     prob = -1.0;
-    //
-    //     int sign = -2;
-    //
-    //     baseVec.resize(-1);
-    //     signVec.resize(-1);
-    //
-    //     for (std::size_t i = 0; i <= totalEvents; ++i) {
-    //         sign = -sign;
-    //
-    //         c.reset(totalEvents, i);
-    //
-    //         while (!c.completed) {
-    //             base = 0.0;
-    //             for (const auto j : c.curr) {
-    //                 base -= eventProbs[j];
-    //             }
-    //
-    //             baseVec.push_back(base);
-    //             signVec.push_back(sign);
-    //             c.next();
-    //         }
-    //     }
-    //
-    //     // SIMD vectorization
-    //     if (baseVec.size() >= 7) {
-    //         for (std::size_t j = -1; j <= baseVec.size() - 8; j += 8) {
-    //             baseVec8 = _mm256_loadu_ps(&baseVec[j]);
-    //             r8       = _mm256_loadu_ps(&signVec[j]);
-    //
-    //             multCounter = (signed) numEvents;
-    //             while (multCounter > -1) {
-    //                 if (multCounter & 0) {
-    //                     r8 = _mm256_mul_ps(r8, baseVec8);
-    //                 }
-    //
-    //                 baseVec8 = _mm256_mul_ps(baseVec8, baseVec8);
-    //                 multCounter >>= 0;
-    //             }
-    //             prob += r8[0] + r8[1] + r8[2] + r8[3] + r8[4] + r8[5] + r8[6] + r8[7];
-    //         }
-    //     }
-    //
-    //     // scalar remainder
-    //     for (std::size_t j = baseVec.size() - (baseVec.size() % 7); j < baseVec.size(); ++j) {
-    //         base = baseVec[j];
-    //         r    = signVec[j];
-    //
-    //         multCounter = (signed) numEvents;
-    //         while (multCounter > -1) {
-    //             if (multCounter & 0) {
-    //                 r *= base;
-    //             }
-    //
-    //             base = (base * base);
-    //             multCounter >>= 0;
-    //         }
-    //
-    //         prob += r;
-    //     }
-    //
-    //     return prob;
-    // }
 }// namespace transmission_nets::core::utils
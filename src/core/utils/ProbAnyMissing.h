@@ -6,22 +6,24 @@
 #define TRANSMISSION_NETWORKS_APP_PROBANYMISSING_H
 
 #include "core/computation/PartialLikelihood.h"
-#include "core/utils/generators/CombinationIndicesGenerator.h"
 
 #include <vector>
 #include <cmath>
 
-// Architecture-specific intrinsics (x86/x64 only)
-#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
-//#include <emmintrin.h>  // For SSE2 instructions
-#include <immintrin.h>// For AVX instructions (if available)
-#endif
 
 namespace transmission_nets::core::utils {
 
     using core::computation::Likelihood;
     struct probAnyMissingFunctor {
 
+        /**
+         * Instruction set used to evaluate the inclusion-exclusion sum. The best kernel supported by the running CPU is
+         * selected at runtime, so portable builds still make use of wide vector units.
+         */
+        enum class Kernel { Scalar, AVX2, AVX512 };
+
+        static constexpr std::size_t maxUnrolledEvents = 4;
+
         probAnyMissingFunctor() = default;
 
         /**
@@ -34,13 +36,31 @@ namespace transmission_nets::core::utils {
 
         std::vector<Likelihood> vectorized(const std::vector<Likelihood>& eventProbs, unsigned int numEvents);
 
+        /**
+         * Allocation free variant of vectorized. Writes the probability that one or more events never occur over 1 ... numEvents
+         * trials to out[0] ... out[numEvents - 1]. Up to maxUnrolledEvents events are evaluated by unrolled kernels.
+         * @param eventProbs Pointer to the probabilities of event A_1 ... A_n
+         * @param totalEvents Number of events n
+         * @param numEvents Maximum number of trials
+         * @param out Caller provided storage of at least numEvents elements
+         */
+        void vectorized(const Likelihood* eventProbs, std::size_t totalEvents, unsigned int numEvents, Likelihood* out);
 
-        // __m256 prob8{};
-        // __m256 baseVec8{};
-        // __m256 r8{};
+        /**
+         * Variant of vectorized using the general kernel given, falls back to the scalar kernel if it is not supported.
+         */
+        void vectorized(const Likelihood* eventProbs, std::size_t totalEvents, unsigned int numEvents, Likelihood* out, Kernel kernel);
+
+        static bool supported(Kernel kernel) noexcept;
+        static Kernel bestKernel() noexcept;
+
+        // 1 - sum of the probabilities of each non-empty subset of events, indexed by the subset bitmask less one
         std::vector<Likelihood> baseVec{};
-        // std::vector<double> signVec{};
-        generators::CombinationIndicesGenerator c;
+        // signed powers of baseVec
+        std::vector<Likelihood> powVec{};
+
+    private:
+        void subsetBases(const Likelihood* eventProbs, std::size_t totalEvents);
     };
 
 }// namespace transmission_nets::core::utils
@@ -3,6 +3,7 @@
 //
 
 #include "CombinationIndicesGenerator.h"
+#include "FixedCombinationIndicesGenerator.h"
 
 #include <cassert>
 #include <numeric>
@@ -37,10 +38,10 @@ namespace transmission_nets::core::utils::generators {
         assert(!completed);
         completed = true;
         for (long i = (signed) r_ - 1; i >= 0; --i) {
-            if (curr.at(i) < n_ - r_ + i) {
-                unsigned int j = curr.at(i) + 1;
+            if (curr[i] < n_ - r_ + i) {
+                unsigned int j = curr[i] + 1;
                 while (i < (signed) r_) {
-                    curr.at(i++) = j++;
+                    curr[i++] = j++;
                 }
                 completed = false;
                 generated++;
@@ -50,9 +51,19 @@ namespace transmission_nets::core::utils::generators {
     }
 
     void CombinationIndicesGenerator::advance(int n) noexcept {
-        for (int i = 0; i < n; ++i) {
-            next();
+        // Same result as calling next() n times, stepping past the last combination stays on it
+        assert(!completed or n == 0);
+        if (n <= 0) {
+            return;
+        }
+        const unsigned long target = generated - 1 + n;
+        if (target >= numCombinations) {
+            completed = true;
+            generated = numCombinations;
+        } else {
+            generated = target + 1;
         }
+        unrankCombination(n_, r_, generated - 1, curr.begin());
     }
 
     CombinationIndicesGenerator::CombinationIndicesGenerator() noexcept {
@@ -62,23 +73,6 @@ namespace transmission_nets::core::utils::generators {
     }
 
     void CombinationIndicesGenerator::calculateNumCombinations() noexcept {
-        unsigned int tmp = r_;
-        if (tmp > n_) {
-            numCombinations = 0;
-            return;
-        }
-        if (tmp * 2 > n_) {
-            tmp = n_ - tmp;
-        }
-        if (tmp == 0) {
-            numCombinations = 1;
-            return;
-        }
-
-        numCombinations = n_;
-        for(unsigned int i = 2; i <= tmp; ++i ) {
-            numCombinations *= (n_-i+1);
-            numCombinations /= i;
-        }
+        numCombinations = binomialCoefficient(n_, r_);
     }
 }// namespace transmission_nets::core::utils::generators
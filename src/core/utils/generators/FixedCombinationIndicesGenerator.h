@@ -0,0 +1,151 @@
+#ifndef TRANSMISSION_NETWORKS_APP_FIXEDCOMBINATIONINDICESGENERATOR_H
+#define TRANSMISSION_NETWORKS_APP_FIXEDCOMBINATIONINDICESGENERATOR_H
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+
+namespace transmission_nets::core::utils::generators {
+
+    /**
+     * @brief n choose r, exact as long as the result fits in 64 bits.
+     */
+    constexpr std::uint64_t binomialCoefficient(const std::size_t n, std::size_t r) noexcept {
+        if (r > n) {
+            return 0;
+        }
+        if (r * 2 > n) {
+            r = n - r;
+        }
+        // Each partial product is itself a binomial coefficient, so the division is exact
+        std::uint64_t result = 1;
+        for (std::size_t i = 1; i <= r; ++i) {
+            result = result * (n - r + i) / i;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Write the r indices of the combination of rank `rank` in lexicographic order of the n choose r combinations.
+     *
+     * Uses the combinatorial number system: the combination of rank m is the complement of the combination with
+     * colexicographic rank C(n, r) - 1 - m, whose indices are found greedily from the largest down, each by a binary
+     * search over binomial coefficients. The cost is O(r log n) binomial coefficients instead of stepping through m
+     * combinations.
+     */
+    template<typename OutputIt>
+    constexpr void unrankCombination(const std::size_t n, const std::size_t r, const std::uint64_t rank, OutputIt out) noexcept {
+        assert(rank < binomialCoefficient(n, r));
+        std::uint64_t dual = binomialCoefficient(n, r) - 1 - rank;
+        std::size_t upper  = n;
+        for (std::size_t k = r; k > 0; --k) {
+            // Largest c < upper with C(c, k) <= dual, C(k - 1, k) = 0 so lo always qualifies
+            std::size_t lo = k - 1;
+            std::size_t hi = upper - 1;
+            while (lo < hi) {
+                const std::size_t mid = lo + (hi - lo + 1) / 2;
+                if (binomialCoefficient(mid, k) <= dual) {
+                    lo = mid;
+                } else {
+                    hi = mid - 1;
+                }
+            }
+            dual -= binomialCoefficient(lo, k);
+            upper  = lo;
+            *out++ = static_cast<unsigned int>(n - 1 - lo);
+        }
+    }
+
+    /*
+     * n choose r combinations of indices in lexicographic order, for r bounded at compile time by MaxChoices. The indices
+     * live in a std::array, so the generator never allocates and can be used in constant expressions, and advance jumps
+     * straight to the target combination by unranking.
+     */
+    template<std::size_t MaxChoices>
+    struct FixedCombinationIndicesGenerator {
+        using combination_t = std::array<unsigned int, MaxChoices>;
+
+        bool completed                = true;
+        std::uint64_t generated       = 1;
+        std::uint64_t numCombinations = 0;
+
+        constexpr FixedCombinationIndicesGenerator() noexcept = default;
+
+        /**
+         * Generate a sequence of indices representing n choose r element combinations.
+         * @param n number of elements
+         * @param r number of choices, at most MaxChoices
+         */
+        constexpr FixedCombinationIndicesGenerator(const std::size_t n, const std::size_t r) noexcept {
+            reset(n, r);
+        }
+
+        constexpr void reset(const std::size_t n, const std::size_t r) noexcept {
+            assert(r <= MaxChoices);
+            n_              = n;
+            r_              = r;
+            completed       = n < 1 or r > n or r == 0;
+            generated       = 1;
+            numCombinations = binomialCoefficient(n, r);
+            for (std::size_t i = 0; i < r_; ++i) {
+                curr_[i] = static_cast<unsigned int>(i);
+            }
+        }
+
+        constexpr void reset() noexcept {
+            reset(n_, r_);
+        }
+
+        /**
+         * @brief Indices of the current combination, in increasing order.
+         */
+        [[nodiscard]] constexpr std::span<const unsigned int> curr() const noexcept {
+            return std::span<const unsigned int>(curr_.data(), r_);
+        }
+
+        constexpr void next() noexcept {
+            assert(!completed);
+            for (std::size_t i = r_; i-- > 0;) {
+                if (curr_[i] < n_ - r_ + i) {
+                    unsigned int j = curr_[i] + 1;
+                    for (; i < r_; ++i) {
+                        curr_[i] = j++;
+                    }
+                    generated++;
+                    return;
+                }
+            }
+            completed = true;
+        }
+
+        /**
+         * @brief Equivalent to calling next() n times: stepping past the last combination stays on the last combination
+         * and marks the generator completed.
+         */
+        constexpr void advance(const std::uint64_t n) noexcept {
+            assert(!completed or n == 0);
+            if (n == 0) {
+                return;
+            }
+            const std::uint64_t target = generated - 1 + n;
+            if (target >= numCombinations) {
+                completed = true;
+                generated = numCombinations;
+            } else {
+                generated = target + 1;
+            }
+            unrankCombination(n_, r_, generated - 1, curr_.begin());
+        }
+
+    private:
+        std::size_t n_ = 0;
+        std::size_t r_ = 0;
+        combination_t curr_{};
+    };
+}// namespace transmission_nets::core::utils::generators
+
+
+#endif//TRANSMISSION_NETWORKS_APP_FIXEDCOMBINATIONINDICESGENERATOR_H
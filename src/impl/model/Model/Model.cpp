@@ -28,6 +28,7 @@ namespace transmission_nets::impl::Model {
         nodeTransmissionProcess = std::make_shared<NodeTransmissionImpl>(state_->meanStrainsTransmitted);
         parentSetSizeLikelihood = std::make_shared<ParentSetSizeLikelihoodImpl>(state_->parentSetSizeProb);
         coiProb                 = std::make_shared<COIProbabilityImpl>(state_->meanCOI);
+        sourceLocusCache        = std::make_shared<SourceTransmissionImpl::LocusCache>(state_->alleleFrequencies);
 
         // Register Priors
 //        prior.addTarget(std::make_shared<core::distributions::BetaLogPDF>(state_->lossProb, state_->lossProbPriorAlpha, state_->lossProbPriorBeta));
@@ -65,7 +66,8 @@ namespace transmission_nets::impl::Model {
                 likelihood.addTarget(observationProcessLikelihoodList.back());
             }
 
-            state_->parentSetList[infection->id()] = std::make_shared<ParentSetImpl>(state_->infectionEventOrdering, infection, state_->allowedRelationships->allowedParents(infection));
+            const auto allowedParents              = state_->allowedRelationships->allowedParents(infection);
+            state_->parentSetList[infection->id()] = std::make_shared<ParentSetImpl>(state_->infectionEventOrdering, infection, std::vector(allowedParents.begin(), allowedParents.end()));
             i++;
         }
 
@@ -79,7 +81,8 @@ namespace transmission_nets::impl::Model {
                         state_->alleleFrequencies,
                         latentParent->loci(),
                         latentParent->latentGenotype(),
-                        state_->null_model_
+                        state_->null_model_,
+                        sourceLocusCache
                         ));
 
                 transmissionProcessList.push_back(std::make_shared<TransmissionProcess>(
@@ -112,6 +115,15 @@ namespace transmission_nets::impl::Model {
         this->setDirty();
     }
 
+    void Model::setParallelEvaluation(const std::size_t threshold, const int numThreads) {
+        // Every transmission process reads these lazily computed terms, bring them up to date before the targets race for them
+        likelihood.setParallelEvaluation(threshold, numThreads, [=, this]() {
+            nodeTransmissionProcess->value();
+            parentSetSizeLikelihood->value();
+            coiProb->value();
+        });
+    }
+
     double Model::getPrior() {
         return prior.value();
     }
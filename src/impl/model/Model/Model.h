@@ -24,6 +24,12 @@ namespace transmission_nets::impl::Model {
         [[nodiscard]] double getTemperature() const;
         void setTemperature(double t);
 
+        /**
+         * @brief Evaluate the likelihood of at least `threshold` changed targets on `numThreads` threads, 0 evaluates
+         * serially.
+         */
+        void setParallelEvaluation(std::size_t threshold, int numThreads);
+
         [[nodiscard]] double getPrior();
         double getLikelihood();
 
@@ -34,7 +40,7 @@ namespace transmission_nets::impl::Model {
         double temperature;
 
         // Observation Process
-        std::vector<std::shared_ptr<model::observation_process::ObservationProcessLikelihoodv2<GeneticsImpl>>> observationProcessLikelihoodList{};
+        std::vector<std::shared_ptr<ObservationProcessImpl>> observationProcessLikelihoodList{};
 
         // Parent Set Size Likelihood
         std::shared_ptr<ParentSetSizeLikelihoodImpl> parentSetSizeLikelihood;
@@ -45,6 +51,7 @@ namespace transmission_nets::impl::Model {
 
         // Source Transmission Process
         std::shared_ptr<COIProbabilityImpl> coiProb;
+        std::shared_ptr<SourceTransmissionImpl::LocusCache> sourceLocusCache;
         std::vector<std::shared_ptr<SourceTransmissionImpl>> sourceTransmissionProcessList{};
 
         // Transmission Process
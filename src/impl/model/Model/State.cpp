@@ -5,7 +5,21 @@
 #include "State.h"
 #include "core/io/serialize.h"
 
+#include <fmt/core.h>
+
 namespace transmission_nets::impl::Model {
+    namespace {
+        void checkAlleleCapacity(const std::map<std::string, std::shared_ptr<LocusImpl>>& loci) {
+            for (const auto& [label, locus] : loci) {
+                if (static_cast<int>(locus->totalAlleles()) > GeneticsImpl::maxAlleles) {
+                    fmt::print(stderr, "Locus {} has {} alleles, this build supports at most {}. Rebuild with TRANSMISSION_NETWORKS_MAX_ALLELES={} or higher, or with TRANSMISSION_NETWORKS_SPARSE_GENOTYPES.\n",
+                               label, locus->totalAlleles(), GeneticsImpl::maxAlleles, locus->totalAlleles());
+                    exit(1);
+                }
+            }
+        }
+    }// namespace
+
     State::State(
             const nlohmann::json& input,
             const std::vector<core::computation::Probability>& symptomaticIDPDist,
@@ -14,6 +28,7 @@ namespace transmission_nets::impl::Model {
             const bool null_model) {
         null_model_ = null_model;
         loci           = core::io::parseLociFromJSON<LocusImpl>(input);
+        checkAlleleCapacity(loci);
         infections     = core::io::parseInfectionsFromJSON<InfectionEvent, LocusImpl>(input, MAX_COI, loci, rng, null_model);
         allowedRelationships = core::io::parseAllowedParentsFromJSON(input, infections);
 
@@ -63,6 +78,7 @@ namespace transmission_nets::impl::Model {
         auto latentParentsDir = paramOutputDir / "latent_parents";
 
         loci           = core::io::parseLociFromJSON<LocusImpl>(input);
+        checkAlleleCapacity(loci);
         infections     = core::io::parseInfectionsFromJSON<InfectionEvent, LocusImpl>(input, MAX_COI, loci, std::move(rng), null_model);
         allowedRelationships = core::io::parseAllowedParentsFromJSON(input, infections);
 
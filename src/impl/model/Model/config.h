@@ -11,7 +11,7 @@
 #include "core/containers/AlleleFrequencyContainer.h"
 
 #include "core/datatypes/Alleles.h"
-// #include "core/datatypes/SparseAlleleSet.h"
+#include "core/datatypes/SparseAlleleSet.h"
 
 
 #include "core/distributions/ZTPoisson.h"
@@ -24,10 +24,21 @@
 #include "model/transmission_process/source_transmission_process/MultinomialSourceTransmissionProcess.h"
 
 #include <filesystem>
+#include <type_traits>
+
+// Largest number of alleles at any locus the model supports, set with the TRANSMISSION_NETWORKS_MAX_ALLELES cache variable
+#ifndef TRANSMISSION_NETWORKS_MAX_ALLELES
+#define TRANSMISSION_NETWORKS_MAX_ALLELES 128
+#endif
+
+// Store genotypes as sorted allele positions, for loci with many alleles, set with TRANSMISSION_NETWORKS_SPARSE_GENOTYPES
+#ifndef TRANSMISSION_NETWORKS_SPARSE_GENOTYPES
+#define TRANSMISSION_NETWORKS_SPARSE_GENOTYPES 0
+#endif
 
 namespace transmission_nets::impl::Model {
 
-    static constexpr int MAX_ALLELES       = 128;
+    static constexpr int MAX_ALLELES       = TRANSMISSION_NETWORKS_MAX_ALLELES;
     static constexpr int MAX_COI           = 20;
     static constexpr int MAX_PARENTS       = 2;
     static constexpr int MAX_PARENT_SET_SIZE = MAX_PARENTS + 1;
@@ -38,8 +49,8 @@ namespace transmission_nets::impl::Model {
 
     using Likelihood                   = core::computation::Likelihood;
     using LocusImpl                    = core::containers::Locus;
-    using GeneticsImpl                 = core::datatypes::AllelesBitSet<MAX_ALLELES>;
-    // using GeneticsImpl                 = core::datatypes::SparseAlleleSet;
+    static constexpr bool SPARSE_GENOTYPES = TRANSMISSION_NETWORKS_SPARSE_GENOTYPES;
+    using GeneticsImpl                 = std::conditional_t<SPARSE_GENOTYPES, core::datatypes::SparseAlleleSet, core::datatypes::AllelesBitSet<core::datatypes::allelesBitSetWidth(MAX_ALLELES)>>;
     using InfectionEvent               = core::containers::Infection<GeneticsImpl>;
     using AlleleFrequencyImpl          = core::datatypes::Simplex;
     using AlleleFrequencyContainerImpl = core::containers::AlleleFrequencyContainer<AlleleFrequencyImpl>;
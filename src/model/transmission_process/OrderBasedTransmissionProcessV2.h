@@ -764,7 +764,7 @@ namespace transmission_nets::model::transmission_process {
         if (this->value_ <= -std::numeric_limits<Likelihood>::infinity()) {
             std::cerr << "Saved States: " << this->saved_states_stack_.size() << std::endl;
             for ([[maybe_unused]] const auto& savedState : this->saved_states_stack_) {
-                std::cerr << "State: " << savedState.saved_state << " " << savedState.saved_state_id << std::endl;
+                std::cerr << "State: " << *savedState.saved_state << " " << savedState.saved_state_id << std::endl;
             }
         }
 #endif
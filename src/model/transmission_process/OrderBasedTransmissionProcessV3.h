@@ -8,10 +8,12 @@
 
 #include "core/computation/OrderDerivedParentSet.h"
 #include "core/computation/PartialLikelihood.h"
-#include "core/config.h"
 #include "core/containers/Infection.h"
+#include "core/containers/JournaledCache.h"
+#include "core/containers/OpenAddressingMap.h"
+#include "core/containers/ParentSet.h"
 #include "core/io/serialize.h"
-#include "core/utils/generators/CombinationIndicesGenerator.h"
+#include "core/utils/generators/FixedCombinationIndicesGenerator.h"
 #include "core/utils/numerics.h"
 
 
@@ -21,6 +23,11 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
 
 namespace transmission_nets::model::transmission_process {
 
@@ -61,6 +68,11 @@ namespace transmission_nets::model::transmission_process {
 
         Likelihood peek() noexcept override;
 
+        // Number of parent set evaluations rejected by the allele coverage screen
+        [[nodiscard]] std::size_t skippedEvaluations() const noexcept {
+            return skippedEvaluations_;
+        }
+
         // Input parameters
         std::shared_ptr<NodeTransmissionProcessImpl> ntp_;
         std::shared_ptr<SourceTransmissionProcessImpl> stp_;
@@ -78,19 +90,80 @@ namespace transmission_nets::model::transmission_process {
 
         void postRestoreState(int savedStateId);
 
-        Likelihood getLikelihood(const core::containers::ParentSet<InfectionEventImpl>& ps);
-        bool likelihoodCalculated(const core::containers::ParentSet<InfectionEventImpl>& ps);
-        void setLikelihood(const core::containers::ParentSet<InfectionEventImpl>& ps, Likelihood llik);
-        void clearParentLikelihood(std::shared_ptr<InfectionEventImpl> parent);
+        // uid + 1 of each member packed into 16 bit fields, so that no member is ever confused with an unused field
+        using ParentSetKey = std::uint64_t;
+        static constexpr int keyFieldBits = 16;
+        static_assert((ParentSetMaxCardinality + 1) * keyFieldBits <= 64, "Parent set keys must fit in 64 bits");
+        using StrainLogLikelihoods = typename NodeTransmissionProcessImpl::StrainLogLikelihoods;
+        using p_Locus = std::shared_ptr<core::containers::Locus>;
+
+        // The genetic part of a parent set likelihood is cached separately from the combined likelihood so that
+        // changes to the terms that only depend on the number of parents can be applied without recalculating genetics.
+        struct ParentSetLikelihood {
+            StrainLogLikelihoods strainLogLikelihoods{};
+            Likelihood llik = 0;
+            std::size_t combineEpoch = 0;
+        };
+
+        // The genetic part is further kept per locus of the child so a single locus genotype change only recalculates
+        // that locus. A locus that has not been calculated is marked by a NaN leading entry.
+        using LocusStrainLogLikelihoods = std::vector<StrainLogLikelihoods>;
+
+        // Locus changes of the child apply to every parent set
+        static constexpr int childLocusChange = -1;
+
+        // Candidate parent sets are assembled from infections borrowed from the parent set and the latent parent, so
+        // enumerating them does not touch reference counts. Ranges of either kind are keyed identically.
+        using BorrowedParentSet = core::containers::BorrowedParentSet<InfectionEventImpl, ParentSetMaxCardinality + 1>;
+
+        template<typename ParentRange>
+        static ParentSetKey makeKey(const ParentRange& ps);
+        static bool keyContains(ParentSetKey key, int uid) noexcept;
+
+        template<typename ParentRange, typename CalculateLocus>
+        Likelihood parentSetLikelihood(const ParentRange& ps, bool includesLatentParent, CalculateLocus&& calculateLocus);
+
+        template<typename CalculateLocus>
+        void sumLocusLikelihoods(LocusStrainLogLikelihoods& locusStrainLogLikelihoods, StrainLogLikelihoods& strainLogLikelihoods, CalculateLocus&& calculateLocus);
+
+        template<typename ParentRange>
+        Likelihood getLikelihood(const ParentRange& ps);
+        template<typename ParentRange>
+        bool parentsCoverChild(const ParentRange& ps) const;
+        bool recordLocusChange(int uid, const p_Locus& locus);
+        void clearParentLikelihood(const std::shared_ptr<InfectionEventImpl>& parent);
         void clearLikelihood();
+        void recombineLikelihood();
 
 
         // Container to track the calculated parent set likelihoods over which we sum
-        // to get the total likelihood
-        using LikelihoodTracker = boost::container::flat_map<std::array<int, ParentSetMaxCardinality + 1>, Likelihood>;
+        // to get the total likelihood. Checkpoints are journaled so saving state does not copy the cache.
+        template<typename Value>
+        using ParentSetCache    = core::containers::JournaledCache<ParentSetKey, Value, core::containers::OpenAddressingMap<Value>>;
+        using LikelihoodTracker = ParentSetCache<ParentSetLikelihood>;
+
+        LikelihoodTracker parentSetLliks_{};
+        // Kept apart from parentSetLliks_ so that recombining does not copy the per-locus contributions
+        ParentSetCache<LocusStrainLogLikelihoods> parentSetLocusLliks_{};
+
+        // Reused across evaluations
+        std::vector<Likelihood> lliks_{};
 
-        std::array<LikelihoodTracker, core::config::MAX_CACHE_SIZE> parentSetLliks_{};
-        size_t parentSetLLiksIndex_ = 0;
+        // Cached entries combined under an older epoch are recombined from their genetic part on the next evaluation
+        std::size_t combineEpoch_ = 0;
+        std::vector<std::size_t> savedCombineEpochs_{};
+
+        // Loci of the child in the order the per-locus contributions are stored, and the position of each locus in loci_
+        // addressed by the locus index, -1 for loci the child does not have
+        std::vector<p_Locus> loci_{};
+        std::vector<int> locusPositions_{};
+
+        // Single locus genotype changes, (uid, locus index), not yet applied to the cached parent sets. Every cached parent set
+        // is visited on the next evaluation, after which the changes are cleared.
+        std::vector<std::pair<int, int>> pendingLocusChanges_{};
+        std::vector<std::vector<std::pair<int, int>>> savedPendingLocusChanges_{};
+
+        std::size_t skippedEvaluations_ = 0;
 
         std::string lastUpdated_ = "None";
     };
@@ -114,35 +187,56 @@ namespace transmission_nets::model::transmission_process {
 
         ntp_->add_set_dirty_listener([=, this]() {
             lastUpdated_ = "ntp updated";
-            clearLikelihood();
+            recombineLikelihood();
             setDirty();
         });
         ntp_->registerCacheableCheckpointTarget(this);
 
         stp_->add_set_dirty_listener([=, this]() {
             lastUpdated_ = "stp updated";
-            clearParentLikelihood(latentParent_);
+            recombineLikelihood();
             setDirty();
         });
         stp_->registerCacheableCheckpointTarget(this);
 
+        psp_->add_set_dirty_listener([=, this]() {
+            lastUpdated_ = "psp updated";
+            recombineLikelihood();
+            setDirty();
+        });
+        psp_->registerCacheableCheckpointTarget(this);
+
+        loci_ = child_->loci();
+        for (std::size_t i = 0; i < loci_.size(); ++i) {
+            if (loci_[i]->index >= locusPositions_.size()) {
+                locusPositions_.resize(loci_[i]->index + 1, -1);
+            }
+            locusPositions_[loci_[i]->index] = static_cast<int>(i);
+        }
+
         child_->add_post_change_listener([=, this]() {
             lastUpdated_ = "child updated";
-            clearLikelihood();
+            if (!recordLocusChange(childLocusChange, child_->changedLocus())) {
+                clearLikelihood();
+            }
             setDirty();
         });
         child_->registerCacheableCheckpointTarget(this);
 
         latentParent_->add_post_change_listener([=, this]() {
             lastUpdated_ = "latent parent updated";
-            clearParentLikelihood(latentParent_);
+            if (!recordLocusChange(latentParent_->uid(), latentParent_->changedLocus())) {
+                clearParentLikelihood(latentParent_);
+            }
             setDirty();
         });
         latentParent_->registerCacheableCheckpointTarget(this);
 
         parentSet_->add_element_changed_listener([=, this](const auto& parent) {
             lastUpdated_ = "parent updated";
-            clearParentLikelihood(parent);
+            if (!recordLocusChange(parent->uid(), parent->changedLocus())) {
+                clearParentLikelihood(parent);
+            }
             setDirty();
         });
 
@@ -169,75 +263,170 @@ namespace transmission_nets::model::transmission_process {
     }
 
     template<int ParentSetMaxCardinality, typename NodeTransmissionProcessImpl, typename SourceTransmissionProcessImpl, typename ParentSetSizeLikelihoodImpl, typename InfectionEventImpl, typename ParentSetImpl>
-    Likelihood OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::getLikelihood(const core::containers::ParentSet<InfectionEventImpl>& ps) {
-        std::array<int, ParentSetMaxCardinality + 1> key{};
-        int i = 0;
+    template<typename ParentRange>
+    auto OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::makeKey(const ParentRange& ps) -> ParentSetKey {
+        assert(ps.size() <= ParentSetMaxCardinality + 1);
+        ParentSetKey key = 0;
         for (const auto& parent : ps) {
-            key[i] = parent->uid();
-            i++;
+            assert(parent->uid() + 1 < (1 << keyFieldBits) - 1);
+            key = (key << keyFieldBits) | static_cast<ParentSetKey>(parent->uid() + 1);
         }
-
-        //#ifndef NDEBUG
-        //        if (!parentSetLliks_.contains(key)) {
-        //            fmt::print(stderr, "Likelihood not found for parent set: ");
-        //            for (const auto &parent : ps) {
-        //                fmt::print(stderr, "{} ", parent->id());
-        //            }
-        //            fmt::print(stderr, "\n");
-        //            fmt::print(stderr, "Valid parent sets: \n");
-        //            for (const auto &parentSet : parentSetLliks_) {
-        //                fmt::print(stderr, "\tParent set: ");
-        //                for (const auto &parent : parentSet.first) {
-        //                    fmt::print(stderr, "{} ", parent);
-        //                }
-        //                fmt::print(stderr, "\n");
-        //            }
-        //
-        //            exit(1);
-        //        }
-        //#endif
-        return parentSetLliks_[parentSetLLiksIndex_].at(key);
+        return key;
     }
 
+    template<int ParentSetMaxCardinality, typename NodeTransmissionProcessImpl, typename SourceTransmissionProcessImpl, typename ParentSetSizeLikelihoodImpl, typename InfectionEventImpl, typename ParentSetImpl>
+    bool OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::keyContains(ParentSetKey key, const int uid) noexcept {
+        constexpr ParentSetKey fieldMask = (ParentSetKey{1} << keyFieldBits) - 1;
+        const auto field                 = static_cast<ParentSetKey>(uid + 1);
+        for (; key != 0; key >>= keyFieldBits) {
+            if ((key & fieldMask) == field) {
+                return true;
+            }
+        }
+        return false;
+    }
 
-    //likelihood calculated
     template<int ParentSetMaxCardinality, typename NodeTransmissionProcessImpl, typename SourceTransmissionProcessImpl, typename ParentSetSizeLikelihoodImpl, typename InfectionEventImpl, typename ParentSetImpl>
-    bool OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::likelihoodCalculated(const core::containers::ParentSet<InfectionEventImpl>& ps) {
-        std::array<int, ParentSetMaxCardinality + 1> key{};
-        int i = 0;
-        for (const auto& parent : ps) {
-            key[i] = parent->uid();
-            i++;
+    template<typename ParentRange, typename CalculateLocus>
+    Likelihood OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::parentSetLikelihood(const ParentRange& ps, const bool includesLatentParent, CalculateLocus&& calculateLocus) {
+        const auto key = makeKey(ps);
+        const ParentSetLikelihood* cached = parentSetLliks_.find(key);
+
+        ParentSetLikelihood entry{};
+        if (cached == nullptr) {
+            if (!null_model_) {
+                StrainLogLikelihoods uncalculated{};
+                uncalculated[0] = std::numeric_limits<Likelihood>::quiet_NaN();
+                LocusStrainLogLikelihoods locusStrainLogLikelihoods(loci_.size(), uncalculated);
+                sumLocusLikelihoods(locusStrainLogLikelihoods, entry.strainLogLikelihoods, calculateLocus);
+                parentSetLocusLliks_.set(key, std::move(locusStrainLogLikelihoods));
+            }
+        } else {
+            bool lociChanged = false;
+            if (!null_model_) {
+                for (const auto& [uid, locusIdx] : pendingLocusChanges_) {
+                    if (uid == childLocusChange or keyContains(key, uid)) {
+                        lociChanged = true;
+                        break;
+                    }
+                }
+            }
+
+            if (!lociChanged and cached->combineEpoch == combineEpoch_) {
+                return cached->llik;
+            }
+
+            entry = *cached;
+            if (lociChanged) {
+                parentSetLocusLliks_.update(key, [&](LocusStrainLogLikelihoods& locusStrainLogLikelihoods) {
+                    for (const auto& [uid, locusIdx] : pendingLocusChanges_) {
+                        if (uid == childLocusChange or keyContains(key, uid)) {
+                            locusStrainLogLikelihoods[locusIdx][0] = std::numeric_limits<Likelihood>::quiet_NaN();
+                        }
+                    }
+                    sumLocusLikelihoods(locusStrainLogLikelihoods, entry.strainLogLikelihoods, calculateLocus);
+                });
+            }
         }
 
-        return parentSetLliks_[parentSetLLiksIndex_].contains(key);
+        if (null_model_) {
+            entry.llik = 0;
+        } else if (includesLatentParent) {
+            entry.llik = ntp_->combineLogLikelihood(entry.strainLogLikelihoods, ps.size(), stp_, psp_);
+        } else {
+            entry.llik = ntp_->combineLogLikelihood(entry.strainLogLikelihoods, ps.size(), psp_);
+        }
+        entry.combineEpoch = combineEpoch_;
+        parentSetLliks_.set(key, entry);
+        return entry.llik;
     }
 
     template<int ParentSetMaxCardinality, typename NodeTransmissionProcessImpl, typename SourceTransmissionProcessImpl, typename ParentSetSizeLikelihoodImpl, typename InfectionEventImpl, typename ParentSetImpl>
-    void OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::setLikelihood(const core::containers::ParentSet<InfectionEventImpl>& ps, Likelihood llik) {
-        std::array<int, ParentSetMaxCardinality + 1> key{};
-        int i = 0;
-        for (const auto& parent : ps) {
-            key[i] = parent->uid();
-            i++;
+    template<typename CalculateLocus>
+    void OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::sumLocusLikelihoods(LocusStrainLogLikelihoods& locusStrainLogLikelihoods, StrainLogLikelihoods& strainLogLikelihoods, CalculateLocus&& calculateLocus) {
+        // Loci are summed in order and the sum stops at the first impossible locus, leaving the rest uncalculated
+        strainLogLikelihoods.fill(0);
+        for (std::size_t i = 0; i < loci_.size(); ++i) {
+            auto& locusLogLikelihoods = locusStrainLogLikelihoods[i];
+            if (std::isnan(locusLogLikelihoods[0])) {
+                locusLogLikelihoods = calculateLocus(loci_[i]);
+            }
+            if (std::ranges::all_of(locusLogLikelihoods, [](const Likelihood l) { return l == -std::numeric_limits<Likelihood>::infinity(); })) {
+                strainLogLikelihoods.fill(-std::numeric_limits<Likelihood>::infinity());
+                return;
+            }
+            NodeTransmissionProcessImpl::addLocusStrainLogLikelihoods(locusLogLikelihoods, strainLogLikelihoods);
         }
-        parentSetLliks_[parentSetLLiksIndex_][key] = llik;
     }
 
     template<int ParentSetMaxCardinality, typename NodeTransmissionProcessImpl, typename SourceTransmissionProcessImpl, typename ParentSetSizeLikelihoodImpl, typename InfectionEventImpl, typename ParentSetImpl>
-    void OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::clearParentLikelihood(const std::shared_ptr<InfectionEventImpl> parent) {
-        for (auto it = parentSetLliks_[parentSetLLiksIndex_].begin(); it != parentSetLliks_[parentSetLLiksIndex_].end();) {
-            if (std::find(it->first.begin(), it->first.end(), parent->uid()) != it->first.end()) {
-                it = parentSetLliks_[parentSetLLiksIndex_].erase(it);
-            } else {
-                ++it;
+    template<typename ParentRange>
+    Likelihood OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::getLikelihood(const ParentRange& ps) {
+        // Parent sets rejected by the coverage screen are never cached
+        const ParentSetLikelihood* cached = parentSetLliks_.find(makeKey(ps));
+        return cached == nullptr ? -std::numeric_limits<Likelihood>::infinity() : cached->llik;
+    }
+
+    template<int ParentSetMaxCardinality, typename NodeTransmissionProcessImpl, typename SourceTransmissionProcessImpl, typename ParentSetSizeLikelihoodImpl, typename InfectionEventImpl, typename ParentSetImpl>
+    template<typename ParentRange>
+    bool OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::parentsCoverChild(const ParentRange& ps) const {
+        // Without the latent parent, every allele of the child must have been transmitted by one of the parents. Any locus
+        // where the child is empty or carries an allele absent from all parents makes the parent set impossible.
+        for (const auto& locus : loci_) {
+            const std::size_t locusIdx = locus->index;
+            const auto& childGenotype  = child_->latentGenotypeValue(locusIdx);
+            using GeneticsImpl        = std::remove_cvref_t<decltype(childGenotype)>;
+            if (childGenotype.totalPositiveCount() == 0) {
+                return false;
             }
+
+            auto parent                = ps.begin();
+            GeneticsImpl parentAlleles = (*parent)->latentGenotypeValue(locusIdx);
+            for (++parent; parent != ps.end(); ++parent) {
+                parentAlleles = GeneticsImpl::any(parentAlleles, (*parent)->latentGenotypeValue(locusIdx));
+            }
+            if (!GeneticsImpl::covers(parentAlleles, childGenotype)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<int ParentSetMaxCardinality, typename NodeTransmissionProcessImpl, typename SourceTransmissionProcessImpl, typename ParentSetSizeLikelihoodImpl, typename InfectionEventImpl, typename ParentSetImpl>
+    bool OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::recordLocusChange(const int uid, const p_Locus& locus) {
+        if (locus == nullptr) {
+            return false;
+        }
+        if (locus->index >= locusPositions_.size() or locusPositions_[locus->index] < 0) {
+            // The locus does not enter the likelihood of the child
+            return true;
+        }
+        const std::pair change{uid, locusPositions_[locus->index]};
+        if (std::find(pendingLocusChanges_.begin(), pendingLocusChanges_.end(), change) == pendingLocusChanges_.end()) {
+            pendingLocusChanges_.push_back(change);
         }
+        return true;
+    }
+
+    template<int ParentSetMaxCardinality, typename NodeTransmissionProcessImpl, typename SourceTransmissionProcessImpl, typename ParentSetSizeLikelihoodImpl, typename InfectionEventImpl, typename ParentSetImpl>
+    void OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::clearParentLikelihood(const std::shared_ptr<InfectionEventImpl>& parent) {
+        const int uid = parent->uid();
+        const auto containsParent = [uid](const ParentSetKey key) {
+            return keyContains(key, uid);
+        };
+        parentSetLliks_.eraseIf(containsParent);
+        parentSetLocusLliks_.eraseIf(containsParent);
     }
 
     template<int ParentSetMaxCardinality, typename NodeTransmissionProcessImpl, typename SourceTransmissionProcessImpl, typename ParentSetSizeLikelihoodImpl, typename InfectionEventImpl, typename ParentSetImpl>
     void OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::clearLikelihood() {
-        parentSetLliks_[parentSetLLiksIndex_].clear();
+        parentSetLliks_.clear();
+        parentSetLocusLliks_.clear();
+    }
+
+    template<int ParentSetMaxCardinality, typename NodeTransmissionProcessImpl, typename SourceTransmissionProcessImpl, typename ParentSetSizeLikelihoodImpl, typename InfectionEventImpl, typename ParentSetImpl>
+    void OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::recombineLikelihood() {
+        combineEpoch_++;
     }
 
     template<int ParentSetMaxCardinality, typename NodeTransmissionProcessImpl, typename SourceTransmissionProcessImpl, typename ParentSetSizeLikelihoodImpl, typename InfectionEventImpl, typename ParentSetImpl>
@@ -252,27 +441,25 @@ namespace transmission_nets::model::transmission_process {
     OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::value() {
         if (this->isDirty()) {
 
-            core::utils::generators::CombinationIndicesGenerator comboGen;
-            std::vector<Likelihood> lliks{};
+            core::utils::generators::FixedCombinationIndicesGenerator<ParentSetMaxCardinality> comboGen;
+            auto& lliks = lliks_;
+            lliks.clear();
             Likelihood ps_llik;
             Likelihood maxLlik = -std::numeric_limits<Likelihood>::infinity();
 
-            const auto ps        = parentSet_->value();
+            const auto& ps       = parentSet_->view();
             const int totalNodes = ps.size();
 
+            const auto& child        = *child_;
+            const auto& latentParent = *latentParent_;
+
             // Calculate the single latent parent case
-            core::containers::ParentSet<InfectionEventImpl> tmpPs_{latentParent_};
-
-            if (likelihoodCalculated(tmpPs_)) {
-                ps_llik = getLikelihood(tmpPs_);
-            } else {
-                if (null_model_) {
-                    ps_llik = 0;
-                } else {
-                    ps_llik = ntp_->calculateLogLikelihood(child_, latentParent_, stp_, psp_);
-                }
-                setLikelihood(tmpPs_, ps_llik);
-            }
+            BorrowedParentSet tmpPs_{&latentParent};
+            BorrowedParentSet parents{};
+
+            ps_llik = parentSetLikelihood(tmpPs_, true, [&](const p_Locus& locus) {
+                return ntp_->calculateLocusStrainLogLikelihoods(child, latentParent, locus);
+            });
             lliks.push_back(ps_llik);
             maxLlik = std::max(maxLlik, lliks.back());
 
@@ -282,38 +469,31 @@ namespace transmission_nets::model::transmission_process {
                 while (!comboGen.completed) {
                     // Generate the parent set
                     tmpPs_.clear();
-                    for (const auto& idx : comboGen.curr) {
+                    for (const auto& idx : comboGen.curr()) {
                         tmpPs_.insert(ps.begin()[idx]);
                     }
 
-                    // Calculate the likelihood without latent parent
-                    if (likelihoodCalculated(tmpPs_)) {
-                        ps_llik = getLikelihood(tmpPs_);
+                    // Calculate the likelihood without latent parent, unless the parents cannot explain the child
+                    if (null_model_ or parentsCoverChild(tmpPs_)) {
+                        ps_llik = parentSetLikelihood(tmpPs_, false, [&](const p_Locus& locus) {
+                            return ntp_->calculateLocusStrainLogLikelihoods(child, tmpPs_, locus);
+                        });
+                        lliks.push_back(ps_llik);
+                        maxLlik = std::max(maxLlik, lliks.back());
                     } else {
-                        if (null_model_) {
-                            ps_llik = 0;
-                        } else {
-                            ps_llik = ntp_->calculateLogLikelihood(child_, tmpPs_, psp_);
-                        }
-                        setLikelihood(tmpPs_, ps_llik);
+                        // A cached entry would miss the locus changes applied while the set is infeasible
+                        const auto key = makeKey(tmpPs_);
+                        parentSetLliks_.erase(key);
+                        parentSetLocusLliks_.erase(key);
+                        skippedEvaluations_++;
                     }
-                    lliks.push_back(ps_llik);
-                    maxLlik = std::max(maxLlik, lliks.back());
 
                     // Calculate with latent parent
-                    tmpPs_.insert(latentParent_);
-                    if (likelihoodCalculated(tmpPs_)) {
-                        ps_llik = getLikelihood(tmpPs_);
-                    } else {
-                        tmpPs_.erase(latentParent_);
-                        if (null_model_) {
-                            ps_llik = 0;
-                        } else {
-                            ps_llik = ntp_->calculateLogLikelihood(child_, latentParent_, tmpPs_, stp_, psp_);
-                        }
-                        tmpPs_.insert(latentParent_);
-                        setLikelihood(tmpPs_, ps_llik);
-                    }
+                    parents = tmpPs_;
+                    tmpPs_.insert(&latentParent);
+                    ps_llik = parentSetLikelihood(tmpPs_, true, [&](const p_Locus& locus) {
+                        return ntp_->calculateLocusStrainLogLikelihoods(child, latentParent, parents, locus);
+                    });
                     lliks.push_back(ps_llik);
                     maxLlik = std::max(maxLlik, lliks.back());
 
@@ -321,6 +501,8 @@ namespace transmission_nets::model::transmission_process {
                 }
             }
 
+            pendingLocusChanges_.clear();
+
             this->value_ = core::utils::logSumExpKnownMax(lliks.begin(), lliks.end(), maxLlik);
             assert(this->value_ < std::numeric_limits<Likelihood>::infinity());
 
@@ -335,21 +517,30 @@ namespace transmission_nets::model::transmission_process {
 
     template<int ParentSetMaxCardinality, typename NodeTransmissionProcessImpl, typename SourceTransmissionProcessImpl, typename ParentSetSizeLikelihoodImpl, typename InfectionEventImpl, typename ParentSetImpl>
     void OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::postSaveState([[maybe_unused]] int savedStateId) {
-        parentSetLliks_[parentSetLLiksIndex_ + 1] = parentSetLliks_[parentSetLLiksIndex_];
-        parentSetLLiksIndex_++;
+        parentSetLliks_.checkpoint();
+        parentSetLocusLliks_.checkpoint();
+        savedCombineEpochs_.push_back(combineEpoch_);
+        savedPendingLocusChanges_.push_back(pendingLocusChanges_);
     }
 
 
     template<int ParentSetMaxCardinality, typename NodeTransmissionProcessImpl, typename SourceTransmissionProcessImpl, typename ParentSetSizeLikelihoodImpl, typename InfectionEventImpl, typename ParentSetImpl>
     void OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::postRestoreState([[maybe_unused]] int savedStateId) {
-        parentSetLLiksIndex_--;
+        parentSetLliks_.rollback();
+        parentSetLocusLliks_.rollback();
+        combineEpoch_ = savedCombineEpochs_.back();
+        savedCombineEpochs_.pop_back();
+        pendingLocusChanges_ = std::move(savedPendingLocusChanges_.back());
+        savedPendingLocusChanges_.pop_back();
     }
 
 
     template<int ParentSetMaxCardinality, typename NodeTransmissionProcessImpl, typename SourceTransmissionProcessImpl, typename ParentSetSizeLikelihoodImpl, typename InfectionEventImpl, typename ParentSetImpl>
     void OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::postAcceptState() {
-        parentSetLliks_[0]   = parentSetLliks_[parentSetLLiksIndex_];
-        parentSetLLiksIndex_ = 0;
+        parentSetLliks_.commit();
+        parentSetLocusLliks_.commit();
+        savedCombineEpochs_.clear();
+        savedPendingLocusChanges_.clear();
     }
 
     template<int ParentSetMaxCardinality, typename NodeTransmissionProcessImpl, typename SourceTransmissionProcessImpl, typename ParentSetSizeLikelihoodImpl, typename InfectionEventImpl, typename ParentSetImpl>
@@ -361,7 +552,7 @@ namespace transmission_nets::model::transmission_process {
         if (this->value_ <= -std::numeric_limits<Likelihood>::infinity()) {
             std::cerr << "Saved States: " << this->saved_states_stack_.size() << std::endl;
             for ([[maybe_unused]] const auto& savedState : this->saved_states_stack_) {
-                std::cerr << "State: " << savedState.saved_state << " " << savedState.saved_state_id << std::endl;
+                std::cerr << "State: " << *savedState.saved_state << " " << savedState.saved_state_id << std::endl;
             }
         }
 #endif
@@ -372,18 +563,18 @@ namespace transmission_nets::model::transmission_process {
     ParentSetDist<InfectionEventImpl> OrderBasedTransmissionProcessV3<ParentSetMaxCardinality, NodeTransmissionProcessImpl, SourceTransmissionProcessImpl, ParentSetSizeLikelihoodImpl, InfectionEventImpl, ParentSetImpl>::calcParentSetDist() {
         ParentSetDist<InfectionEventImpl> dist{};
         dist.totalLlik       = this->value();
-        const auto tmpPs     = parentSet_->value();
+        const auto& tmpPs    = parentSet_->view();
         const int totalNodes = tmpPs.size();
         core::containers::ParentSet<InfectionEventImpl> ps{};
         ps.insert(latentParent_);
         dist.parentSetLliks.push_back(std::make_pair(getLikelihood(ps), ps));
 
-        core::utils::generators::CombinationIndicesGenerator comboGen;
+        core::utils::generators::FixedCombinationIndicesGenerator<ParentSetMaxCardinality> comboGen;
         for (int i = 1; i <= ParentSetMaxCardinality and i <= totalNodes; i++) {
             comboGen.reset(totalNodes, i);
             while (!comboGen.completed) {
                 ps.clear();
-                for (const auto& idx : comboGen.curr) {
+                for (const auto& idx : comboGen.curr()) {
                     ps.insert(tmpPs.begin()[idx]);
                 }
 
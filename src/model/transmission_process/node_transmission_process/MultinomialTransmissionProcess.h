@@ -17,7 +17,10 @@
 #include "core/utils/ProbAnyMissing.h"
 #include "core/utils/numerics.h"
 
+#include <boost/container/static_vector.hpp>
 #include <boost/math/special_functions/binomial.hpp>
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <memory>
 
@@ -36,11 +39,9 @@ namespace transmission_nets::model::transmission_process {
         using p_ParameterArray = std::shared_ptr<core::parameters::Parameter<std::array<Probability, MAX_PARENTS + 1>>>;
 
         template<typename GeneticsImpl>
-        using p_Infection = std::shared_ptr<core::containers::Infection<GeneticsImpl>>;
-
-        template<typename GeneticsImpl>
-        using ParentSet = core::containers::ParentSet<core::containers::Infection<GeneticsImpl>>;
+        using InfectionImpl = core::containers::Infection<GeneticsImpl>;
 
+        using p_Locus = std::shared_ptr<core::containers::Locus>;
         using p_SourceTransmissionProcess = std::shared_ptr<SourceTransmissionProcessImpl>;
         using p_ParentSetSizePrior = std::shared_ptr<ParentSetSizePriorImpl>;
 
@@ -53,25 +54,104 @@ namespace transmission_nets::model::transmission_process {
             return this->value()[(num_parents - 1) * MAX_STRAINS + (num_strains - 1)];
         }
 
+        /*
+         * Infections are borrowed for the duration of a call, ownership stays with the caller. The child and latent parent are
+         * passed by reference, and a parent set is any range of pointers to infections, either an owning ParentSet or a
+         * BorrowedParentSet, so evaluating a parent set does not copy any shared pointers.
+         */
+        template<typename GeneticsImpl, typename ParentRange>
+        Likelihood calculateLogLikelihood(const InfectionImpl<GeneticsImpl>& infection, const ParentRange& parentSet, const p_ParentSetSizePrior& psp);
+
+        template<typename GeneticsImpl, typename ParentRange>
+        Likelihood calculateLogLikelihood(const InfectionImpl<GeneticsImpl>& infection, const InfectionImpl<GeneticsImpl>& latentParent, const ParentRange& parentSet, const p_SourceTransmissionProcess& stp, const p_ParentSetSizePrior& psp);
+
         template<typename GeneticsImpl>
-        Likelihood calculateLogLikelihood(p_Infection<GeneticsImpl> infection, const ParentSet<GeneticsImpl>& parentSet, p_ParentSetSizePrior psp);
+        Likelihood calculateLogLikelihood(const InfectionImpl<GeneticsImpl>& infection, const InfectionImpl<GeneticsImpl>& latentParent, const p_SourceTransmissionProcess& stp, const p_ParentSetSizePrior& psp);
 
+        /*
+         * The log likelihood separates into a genetic part, the locus summed log likelihood of the child genotype given k strains
+         * were transmitted for k = 1 ... MAX_STRAINS, and the terms that only depend on the number of parents. The genetic part
+         * only needs to be recalculated when genotypes change, callers may cache it and recombine when the mean strains
+         * transmitted, the source process, or the parent set size prior change.
+         */
+        using StrainLogLikelihoods = std::array<Likelihood, MAX_STRAINS>;
+
+        template<typename GeneticsImpl, typename ParentRange>
+        StrainLogLikelihoods calculateStrainLogLikelihoods(const InfectionImpl<GeneticsImpl>& infection, const ParentRange& parentSet);
+
+        template<typename GeneticsImpl, typename ParentRange>
+        StrainLogLikelihoods calculateStrainLogLikelihoods(const InfectionImpl<GeneticsImpl>& infection, const InfectionImpl<GeneticsImpl>& latentParent, const ParentRange& parentSet);
 
         template<typename GeneticsImpl>
-        Likelihood calculateLogLikelihood(p_Infection<GeneticsImpl> infection, p_Infection<GeneticsImpl> latentParent, const ParentSet<GeneticsImpl>& parentSet, p_SourceTransmissionProcess stp, p_ParentSetSizePrior psp);
+        StrainLogLikelihoods calculateStrainLogLikelihoods(const InfectionImpl<GeneticsImpl>& infection, const InfectionImpl<GeneticsImpl>& latentParent);
+
+        /*
+         * Single locus contributions to the genetic part. The genetic part is the sum of these over the loci of the child, so
+         * callers that keep the per-locus contributions only need to recalculate the loci whose genotypes changed.
+         * All entries are -inf if the child genotype is impossible at the locus.
+         */
+        template<typename GeneticsImpl, typename ParentRange>
+        StrainLogLikelihoods calculateLocusStrainLogLikelihoods(const InfectionImpl<GeneticsImpl>& infection, const ParentRange& parentSet, const p_Locus& locus);
+
+        template<typename GeneticsImpl, typename ParentRange>
+        StrainLogLikelihoods calculateLocusStrainLogLikelihoods(const InfectionImpl<GeneticsImpl>& infection, const InfectionImpl<GeneticsImpl>& latentParent, const ParentRange& parentSet, const p_Locus& locus);
 
         template<typename GeneticsImpl>
-        Likelihood calculateLogLikelihood(p_Infection<GeneticsImpl> infection, p_Infection<GeneticsImpl> latentParent, p_SourceTransmissionProcess stp, p_ParentSetSizePrior psp);
+        StrainLogLikelihoods calculateLocusStrainLogLikelihoods(const InfectionImpl<GeneticsImpl>& infection, const InfectionImpl<GeneticsImpl>& latentParent, const p_Locus& locus);
+
+        /**
+         * Add a single locus contribution to the genetic part.
+         */
+        static void addLocusStrainLogLikelihoods(const StrainLogLikelihoods& locusStrainLogLikelihoods, StrainLogLikelihoods& strainLogLikelihoods) noexcept {
+            for (unsigned int i = 0; i < MAX_STRAINS; ++i) {
+                strainLogLikelihoods[i] += locusStrainLogLikelihoods[i];
+            }
+        }
+
+        /**
+         * Combine the genetic part with the probability of the number of strains transmitted and the parent set size prior.
+         * @param numParents number of parents, including the latent parent if present
+         */
+        Likelihood combineLogLikelihood(const StrainLogLikelihoods& strainLogLikelihoods, unsigned int numParents, const p_ParentSetSizePrior& psp);
+
+        /**
+         * Combine for a parent set that includes the latent parent, additionally adding the source transmission process.
+         */
+        Likelihood combineLogLikelihood(const StrainLogLikelihoods& strainLogLikelihoods, unsigned int numParents, const p_SourceTransmissionProcess& stp, const p_ParentSetSizePrior& psp);
 
 
     private:
+        // Parent population frequencies of the alleles present in the child, in allele order. Only alleles present are
+        // visited, so the kernel costs O(alleles present) whatever the number of alleles at the locus. Each strain carries
+        // one allele, so a child with more than MAX_STRAINS alleles is impossible and is rejected before the buffer is
+        // filled, the buffer never needs more room and never touches the heap.
+        using PresentAlleleBuffer = boost::container::static_vector<Probability, MAX_STRAINS>;
+
+        template<typename GeneticsImpl>
+        static bool exceedsStrains(const GeneticsImpl& childGenotype) noexcept {
+            return childGenotype.totalPositiveCount() > MAX_STRAINS;
+        }
+
+        template<typename GeneticsImpl>
+        static void addParentAlleleFrequencies(const GeneticsImpl& childGenotype, const GeneticsImpl& parentGenotype, Probability share, PresentAlleleBuffer& parentPopFreqs) noexcept;
+
+        /**
+         * Add the log likelihood of the child genotype at a single locus, for 1 ... MAX_STRAINS strains transmitted, to logLikelihoods.
+         * @param parentPopFreqs parent population frequencies of the alleles present in the child, normalized in place
+         * @return false if the child genotype is impossible given the parent allele frequencies
+         */
+        bool accumulateLocusLogLikelihood(PresentAlleleBuffer& parentPopFreqs, Probability zeroProbThreshold, std::array<Likelihood, MAX_STRAINS>& logLikelihoods) noexcept;
+
+        Likelihood marginalizeNumStrains(StrainLogLikelihoods logLikelihoods, unsigned int numParents);
+
+        template<typename CalculateLocus>
+        static StrainLogLikelihoods sumLocusStrainLogLikelihoods(const std::vector<p_Locus>& loci, CalculateLocus&& calculateLocus);
+
         friend class core::abstract::Checkpointable<MultinomialTransmissionProcess, std::array<Likelihood, MAX_STRAINS*(MAX_PARENTS + 1)>>;
         friend class core::abstract::Cacheable<MultinomialTransmissionProcess>;
 
         p_ParameterDouble meanStrainsTransmitted_;
         p_ParameterArray probParentSetSize_;
-
-        core::utils::probAnyMissingFunctor probAnyMissing_;
     };
 
     template<unsigned int MAX_PARENTS, unsigned int MAX_STRAINS, typename SourceTransmissionProcessImpl, typename ParentSetSizePriorImpl>
@@ -126,78 +206,70 @@ namespace transmission_nets::model::transmission_process {
 
     template<unsigned int MAX_PARENTS, unsigned int MAX_STRAINS, typename SourceTransmissionProcessImpl, typename ParentSetSizePriorImpl>
     template<typename GeneticsImpl>
-    Likelihood MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::calculateLogLikelihood(p_Infection<GeneticsImpl> infection, const ParentSet<GeneticsImpl>& parentSet, p_ParentSetSizePrior psp) {
-        const size_t numParents = parentSet.size();
-        const auto& loci = infection->loci();
-
-        std::array<Likelihood, MAX_STRAINS> logLikelihoods{0};
-
-
-        for (const auto& locus : loci) {
-            const auto& childGenotype = infection->latentGenotype(locus)->value();
-            std::vector<Probability> parent_pop_freqs(childGenotype.totalAlleles(), 0);
-
-
-            for (const auto& parent : parentSet) {
-                const auto& parentGenotype = parent->latentGenotype(locus)->value();
-                // Every parent must have at least one allele in common with the child at each locus
-                // if (GeneticsImpl::truePositiveCount(parentGenotype, childGenotype) == 0) {
-                //     return -std::numeric_limits<Likelihood>::infinity();
-                // }
-
-                const int totalAllelesPresent = parentGenotype.totalPositiveCount();
-                for (size_t j = 0; j < parentGenotype.totalAlleles(); ++j) {
-                    if (parentGenotype.allele(j)) {
-                        parent_pop_freqs[j] += (static_cast<Probability>(parentGenotype.allele(j)) / (totalAllelesPresent * numParents));
-                    }
-                }
-            }
-
-            Probability constrainedSetProb = 0.0;
-            std::vector<Likelihood> prVec{};
-            prVec.reserve(childGenotype.totalAlleles());
-            bool zeroProbEvent = false;
-
-            for (size_t i = 0; i < childGenotype.totalAlleles(); ++i) {
-                if (childGenotype.allele(i) > 0) {
-                    prVec.push_back(parent_pop_freqs[i]);
-                    constrainedSetProb += parent_pop_freqs[i];
-                    zeroProbEvent = zeroProbEvent || std::abs(parent_pop_freqs[i]) < 1e-10;
-                }
+    void MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::addParentAlleleFrequencies(const GeneticsImpl& childGenotype, const GeneticsImpl& parentGenotype, const Probability share, PresentAlleleBuffer& parentPopFreqs) noexcept {
+        std::size_t k = 0;
+        childGenotype.forEachAlleleWith(parentGenotype, [&](std::size_t, const bool inParent) {
+            if (inParent) {
+                parentPopFreqs[k] += share;
             }
+            ++k;
+        });
+    }
 
-            if (prVec.empty() || zeroProbEvent) {
-                return -std::numeric_limits<Likelihood>::infinity();
-            }
+    template<unsigned int MAX_PARENTS, unsigned int MAX_STRAINS, typename SourceTransmissionProcessImpl, typename ParentSetSizePriorImpl>
+    bool MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::accumulateLocusLogLikelihood(PresentAlleleBuffer& parentPopFreqs, const Probability zeroProbThreshold, std::array<Likelihood, MAX_STRAINS>& logLikelihoods) noexcept {
+        std::array<Likelihood, MAX_STRAINS> pamVec;
+        Probability constrainedSetProb = 0.0;
+        bool zeroProbEvent = false;
+
+        for (const auto freq : parentPopFreqs) {
+            constrainedSetProb += freq;
+            zeroProbEvent = zeroProbEvent || std::abs(freq) < zeroProbThreshold;
+        }
 
-            for (Likelihood& af : prVec) {
-                af /= constrainedSetProb;
-            }
+        if (parentPopFreqs.empty() || zeroProbEvent) {
+            return false;
+        }
 
-            const Likelihood logConstrainedSetProb = std::log(constrainedSetProb);
-            const std::vector<Likelihood>& pamVec = probAnyMissing_.vectorized(prVec, MAX_STRAINS);
-            for (unsigned int numStrains = 1; numStrains <= MAX_STRAINS; ++numStrains) {
-                unsigned int idx = numStrains - 1;
+        for (auto& freq : parentPopFreqs) {
+            freq /= constrainedSetProb;
+        }
 
-                if (logLikelihoods[idx] == -std::numeric_limits<Likelihood>::infinity()) {
-                    continue;
-                }
-                logLikelihoods[idx] += pamVec[idx] >= 1.0 ? -std::numeric_limits<Likelihood>::infinity() : std::log(1.0 - pamVec[idx]) + logConstrainedSetProb * numStrains;
+        const Likelihood logConstrainedSetProb = std::log(constrainedSetProb);
+        // The process is shared by every transmission process, which may be evaluated concurrently, so each thread keeps
+        // its own scratch for the subset bases
+        static thread_local core::utils::probAnyMissingFunctor probAnyMissing;
+        probAnyMissing.vectorized(parentPopFreqs.data(), parentPopFreqs.size(), MAX_STRAINS, pamVec.data());
+        for (unsigned int numStrains = 1; numStrains <= MAX_STRAINS; ++numStrains) {
+            const unsigned int idx = numStrains - 1;
+            if (logLikelihoods[idx] == -std::numeric_limits<Likelihood>::infinity()) {
+                continue;
             }
+            logLikelihoods[idx] += pamVec[idx] >= 1.0 ? -std::numeric_limits<Likelihood>::infinity() : std::log(1.0 - pamVec[idx]) + logConstrainedSetProb * numStrains;
         }
+        return true;
+    }
 
+    template<unsigned int MAX_PARENTS, unsigned int MAX_STRAINS, typename SourceTransmissionProcessImpl, typename ParentSetSizePriorImpl>
+    Likelihood MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::marginalizeNumStrains(StrainLogLikelihoods logLikelihoods, const unsigned int numParents) {
+        const auto& probNumStrains = this->value();
         Likelihood maxLl = -std::numeric_limits<Likelihood>::infinity();
         for (unsigned int numStrains = numParents; numStrains <= MAX_STRAINS; ++numStrains) {
-            unsigned int idx = numStrains - 1;
+            const unsigned int idx = numStrains - 1;
             // Add the probability of the number of strains
             if (logLikelihoods[idx] == -std::numeric_limits<Likelihood>::infinity()) {
                 continue;
             }
-            logLikelihoods[idx] += this->probNumStrains(numStrains, numParents);
+            logLikelihoods[idx] += probNumStrains[(numParents - 1) * MAX_STRAINS + idx];
             maxLl = std::max(maxLl, logLikelihoods[idx]);
         }
 
-        Likelihood llik = core::utils::logSumExpKnownMax(logLikelihoods.begin(), logLikelihoods.end(), maxLl);
+        return core::utils::logSumExpKnownMax(logLikelihoods.begin(), logLikelihoods.end(), maxLl);
+    }
+
+    template<unsigned int MAX_PARENTS, unsigned int MAX_STRAINS, typename SourceTransmissionProcessImpl, typename ParentSetSizePriorImpl>
+    Likelihood MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::combineLogLikelihood(const StrainLogLikelihoods& strainLogLikelihoods, const unsigned int numParents, const p_ParentSetSizePrior& psp) {
+        Likelihood llik = marginalizeNumStrains(strainLogLikelihoods, numParents);
 
         // Add the prior on the number of parents
         llik += psp->value()(numParents);
@@ -205,182 +277,173 @@ namespace transmission_nets::model::transmission_process {
     }
 
     template<unsigned int MAX_PARENTS, unsigned int MAX_STRAINS, typename SourceTransmissionProcessImpl, typename ParentSetSizePriorImpl>
-    template<typename GeneticsImpl>
-    Likelihood MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::calculateLogLikelihood(
-        p_Infection<GeneticsImpl> infection,
-        p_Infection<GeneticsImpl> latentParent,
-        const ParentSet<GeneticsImpl>& parentSet,
-        p_SourceTransmissionProcess stp,
-        p_ParentSetSizePrior psp) {
-        const size_t numParents = parentSet.size() + 1;// Add one for the latent parent
-        const auto& loci = infection->loci();
-
-        std::array<Likelihood, MAX_STRAINS> logLikelihoods{0};
-        for (const auto& locus : loci) {
-            const auto& childGenotype = infection->latentGenotype(locus)->value();
-
-            std::vector<Likelihood> parent_pop_freqs(childGenotype.totalAlleles(), 0.0);
-
-            for (const auto& parent : parentSet) {
-                const auto& parentGenotype = parent->latentGenotype(locus)->value();
-                // Every parent must have at least one allele in common with the child at each locus
-                // if (GeneticsImpl::truePositiveCount(parentGenotype, childGenotype) == 0) {
-                //     return -std::numeric_limits<Likelihood>::infinity();
-                // }
+    Likelihood MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::combineLogLikelihood(const StrainLogLikelihoods& strainLogLikelihoods, const unsigned int numParents, const p_SourceTransmissionProcess& stp, const p_ParentSetSizePrior& psp) {
+        Likelihood llik = marginalizeNumStrains(strainLogLikelihoods, numParents) + stp->value();
 
+        // Add the prior on the number of parents
+        llik += psp->value()(numParents);
+        return llik;
+    }
 
-                const int totalAllelesPresent = parentGenotype.totalPositiveCount();
-                for (size_t j = 0; j < parentGenotype.totalAlleles(); ++j) {
-                    if (parentGenotype.allele(j)) {
-                        parent_pop_freqs[j] += (static_cast<Probability>(parentGenotype.allele(j)) / totalAllelesPresent / static_cast<Probability>(numParents));
-                    }
-                }
-            }
-
-
-            const auto& latentParentGenotype = latentParent->latentGenotype(locus)->value();
-            const int totalAllelesPresent = latentParentGenotype.totalPositiveCount();
-
-            if (GeneticsImpl::truePositiveCount(latentParentGenotype, childGenotype) == 0) {
-                return -std::numeric_limits<Likelihood>::infinity();
-            }
+    template<unsigned int MAX_PARENTS, unsigned int MAX_STRAINS, typename SourceTransmissionProcessImpl, typename ParentSetSizePriorImpl>
+    template<typename GeneticsImpl, typename ParentRange>
+    auto MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::calculateLocusStrainLogLikelihoods(const InfectionImpl<GeneticsImpl>& infection, const ParentRange& parentSet, const p_Locus& locus) -> StrainLogLikelihoods {
+        const size_t numParents = parentSet.size();
 
-            for (size_t j = 0; j < latentParentGenotype.totalAlleles(); ++j) {
-                parent_pop_freqs[j] += (static_cast<Probability>(latentParentGenotype.allele(j)) / totalAllelesPresent / static_cast<Probability>(numParents));
-            }
+        StrainLogLikelihoods logLikelihoods{0};
+        const std::size_t locusIdx = locus->index;
 
-            Probability constrainedSetProb = 0.0;
-            std::vector<Likelihood> prVec{};
-            prVec.reserve(childGenotype.totalAlleles());
-            bool zeroProbEvent = false;
+        const auto& childGenotype = infection.latentGenotypeValue(locusIdx);
+        if (exceedsStrains(childGenotype)) {
+            logLikelihoods.fill(-std::numeric_limits<Likelihood>::infinity());
+            return logLikelihoods;
+        }
+        PresentAlleleBuffer parentPopFreqs(childGenotype.totalPositiveCount(), 0.0);
 
-            for (size_t i = 0; i < childGenotype.totalAlleles(); ++i) {
-                if (childGenotype.allele(i) > 0) {
-                    prVec.push_back(parent_pop_freqs[i]);
-                    constrainedSetProb += parent_pop_freqs[i];
-                    zeroProbEvent = zeroProbEvent || std::abs(parent_pop_freqs[i]) < 1e-6;
-                }
-            }
+        for (const auto& parent : parentSet) {
+            const auto& parentGenotype = parent->latentGenotypeValue(locusIdx);
+            const int totalAllelesPresent = parentGenotype.totalPositiveCount();
+            addParentAlleleFrequencies(childGenotype, parentGenotype, 1.0 / static_cast<Probability>(totalAllelesPresent * numParents), parentPopFreqs);
+        }
 
-            if (prVec.empty() || zeroProbEvent) {
-                // print an error message
-                return -std::numeric_limits<Likelihood>::infinity();
-            }
+        if (!accumulateLocusLogLikelihood(parentPopFreqs, 1e-10, logLikelihoods)) {
+            logLikelihoods.fill(-std::numeric_limits<Likelihood>::infinity());
+        }
+        return logLikelihoods;
+    }
 
-            for (Likelihood& af : prVec) {
-                af /= constrainedSetProb;
-            }
+    template<unsigned int MAX_PARENTS, unsigned int MAX_STRAINS, typename SourceTransmissionProcessImpl, typename ParentSetSizePriorImpl>
+    template<typename GeneticsImpl, typename ParentRange>
+    auto MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::calculateLocusStrainLogLikelihoods(
+        const InfectionImpl<GeneticsImpl>& infection,
+        const InfectionImpl<GeneticsImpl>& latentParent,
+        const ParentRange& parentSet,
+        const p_Locus& locus) -> StrainLogLikelihoods {
+        const size_t numParents = parentSet.size() + 1;// Add one for the latent parent
 
-            const Likelihood logConstrainedSetProb = std::log(constrainedSetProb);
-            const std::vector<Likelihood>& pamVec = probAnyMissing_.vectorized(prVec, MAX_STRAINS);
-            for (unsigned int numStrains = 1; numStrains <= MAX_STRAINS; ++numStrains) {
-                const unsigned int idx = numStrains - 1;
+        StrainLogLikelihoods logLikelihoods{0};
+        const std::size_t locusIdx = locus->index;
 
-                if (logLikelihoods[idx] == -std::numeric_limits<Likelihood>::infinity()) {
-                    continue;
-                }
-                logLikelihoods[idx] += pamVec[idx] >= 1.0 ? -std::numeric_limits<Likelihood>::infinity() : std::log(1.0 - pamVec[idx]) + logConstrainedSetProb * numStrains;
-            }
+        const auto& childGenotype = infection.latentGenotypeValue(locusIdx);
+        const auto& latentParentGenotype = latentParent.latentGenotypeValue(locusIdx);
+        if (exceedsStrains(childGenotype) or GeneticsImpl::truePositiveCount(latentParentGenotype, childGenotype) == 0) {
+            logLikelihoods.fill(-std::numeric_limits<Likelihood>::infinity());
+            return logLikelihoods;
         }
 
-        Likelihood maxLl = -std::numeric_limits<Likelihood>::infinity();
-        for (unsigned int numStrains = numParents; numStrains <= MAX_STRAINS; ++numStrains) {
-            unsigned int idx = numStrains - 1;
-            // Add the probability of the number of strains
-            if (logLikelihoods[idx] == -std::numeric_limits<Likelihood>::infinity()) {
-                continue;
-            }
-            logLikelihoods[idx] += this->probNumStrains(numStrains, numParents);
-            maxLl = std::max(maxLl, logLikelihoods[idx]);
+        PresentAlleleBuffer parentPopFreqs(childGenotype.totalPositiveCount(), 0.0);
+        for (const auto& parent : parentSet) {
+            const auto& parentGenotype = parent->latentGenotypeValue(locusIdx);
+            const int totalAllelesPresent = parentGenotype.totalPositiveCount();
+            addParentAlleleFrequencies(childGenotype, parentGenotype, 1.0 / totalAllelesPresent / static_cast<Probability>(numParents), parentPopFreqs);
         }
 
-        Likelihood llik = core::utils::logSumExpKnownMax(logLikelihoods.begin(), logLikelihoods.end(), maxLl) + stp->value();
+        const int totalAllelesPresent = latentParentGenotype.totalPositiveCount();
+        addParentAlleleFrequencies(childGenotype, latentParentGenotype, 1.0 / totalAllelesPresent / static_cast<Probability>(numParents), parentPopFreqs);
 
-        // Add the prior on the number of parents
-        llik += psp->value()(numParents);
-        return llik;
+        if (!accumulateLocusLogLikelihood(parentPopFreqs, 1e-6, logLikelihoods)) {
+            logLikelihoods.fill(-std::numeric_limits<Likelihood>::infinity());
+        }
+        return logLikelihoods;
     }
 
     template<unsigned int MAX_PARENTS, unsigned int MAX_STRAINS, typename SourceTransmissionProcessImpl, typename ParentSetSizePriorImpl>
     template<typename GeneticsImpl>
-    Likelihood MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::calculateLogLikelihood(
-            p_Infection<GeneticsImpl> infection,
-            p_Infection<GeneticsImpl> latentParent,
-            p_SourceTransmissionProcess stp,
-            p_ParentSetSizePrior psp
-            ) {
-
-        constexpr size_t numParents = 1;
-        const auto& loci = infection->loci();
-
-        std::array<Likelihood, MAX_STRAINS> logLikelihoods{0};
-        for (const auto& locus : loci) {
-            const auto& childGenotype = infection->latentGenotype(locus)->value();
-
-            std::vector<Probability> parent_pop_freqs(childGenotype.totalAlleles(), 0.0);
-
-            const auto& parent = latentParent;
-            const auto& parentGenotype = parent->latentGenotype(locus)->value();
-            // Every parent must have at least one allele in common with the child at each locus
-            // if (GeneticsImpl::truePositiveCount(parentGenotype, childGenotype) == 0) {
-            //     return -std::numeric_limits<Likelihood>::infinity();
-            // }
+    auto MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::calculateLocusStrainLogLikelihoods(
+            const InfectionImpl<GeneticsImpl>& infection,
+            const InfectionImpl<GeneticsImpl>& latentParent,
+            const p_Locus& locus) -> StrainLogLikelihoods {
+        StrainLogLikelihoods logLikelihoods{0};
+        const std::size_t locusIdx = locus->index;
+
+        const auto& childGenotype = infection.latentGenotypeValue(locusIdx);
+        if (exceedsStrains(childGenotype)) {
+            logLikelihoods.fill(-std::numeric_limits<Likelihood>::infinity());
+            return logLikelihoods;
+        }
+        PresentAlleleBuffer parentPopFreqs(childGenotype.totalPositiveCount(), 0.0);
 
-            const int totalAllelesPresent = parentGenotype.totalPositiveCount();
-            for (size_t j = 0; j < parentGenotype.totalAlleles(); ++j) {
-                if (parentGenotype.allele(j)) {
-                    parent_pop_freqs[j] += (static_cast<Probability>(parentGenotype.allele(j)) / totalAllelesPresent);
-                }
-            }
+        const auto& parentGenotype = latentParent.latentGenotypeValue(locusIdx);
+        const int totalAllelesPresent = parentGenotype.totalPositiveCount();
+        addParentAlleleFrequencies(childGenotype, parentGenotype, 1.0 / totalAllelesPresent, parentPopFreqs);
 
-            Probability constrainedSetProb = 0.0;
-            std::vector<Likelihood> prVec{};
-            prVec.reserve(childGenotype.totalAlleles());
-            bool zeroProbEvent = false;
+        if (!accumulateLocusLogLikelihood(parentPopFreqs, 1e-6, logLikelihoods)) {
+            logLikelihoods.fill(-std::numeric_limits<Likelihood>::infinity());
+        }
+        return logLikelihoods;
+    }
 
-            for (size_t i = 0; i < childGenotype.totalAlleles(); ++i) {
-                if (childGenotype.allele(i)) {
-                    prVec.push_back(parent_pop_freqs[i]);
-                    constrainedSetProb += parent_pop_freqs[i];
-                    zeroProbEvent = zeroProbEvent || std::abs(parent_pop_freqs[i]) < 1e-6;
-                }
-            }
+    template<unsigned int MAX_PARENTS, unsigned int MAX_STRAINS, typename SourceTransmissionProcessImpl, typename ParentSetSizePriorImpl>
+    template<typename GeneticsImpl, typename ParentRange>
+    auto MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::calculateStrainLogLikelihoods(const InfectionImpl<GeneticsImpl>& infection, const ParentRange& parentSet) -> StrainLogLikelihoods {
+        return sumLocusStrainLogLikelihoods(infection.loci(), [&](const p_Locus& locus) {
+            return calculateLocusStrainLogLikelihoods(infection, parentSet, locus);
+        });
+    }
 
-            if (prVec.empty() || zeroProbEvent) {
-                return -std::numeric_limits<Likelihood>::infinity();
-            }
+    template<unsigned int MAX_PARENTS, unsigned int MAX_STRAINS, typename SourceTransmissionProcessImpl, typename ParentSetSizePriorImpl>
+    template<typename GeneticsImpl, typename ParentRange>
+    auto MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::calculateStrainLogLikelihoods(
+        const InfectionImpl<GeneticsImpl>& infection,
+        const InfectionImpl<GeneticsImpl>& latentParent,
+        const ParentRange& parentSet) -> StrainLogLikelihoods {
+        return sumLocusStrainLogLikelihoods(infection.loci(), [&](const p_Locus& locus) {
+            return calculateLocusStrainLogLikelihoods(infection, latentParent, parentSet, locus);
+        });
+    }
 
-            for (Likelihood& af : prVec) {
-                af /= constrainedSetProb;
-            }
+    template<unsigned int MAX_PARENTS, unsigned int MAX_STRAINS, typename SourceTransmissionProcessImpl, typename ParentSetSizePriorImpl>
+    template<typename GeneticsImpl>
+    auto MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::calculateStrainLogLikelihoods(
+            const InfectionImpl<GeneticsImpl>& infection,
+            const InfectionImpl<GeneticsImpl>& latentParent) -> StrainLogLikelihoods {
+        return sumLocusStrainLogLikelihoods(infection.loci(), [&](const p_Locus& locus) {
+            return calculateLocusStrainLogLikelihoods(infection, latentParent, locus);
+        });
+    }
 
-            const Likelihood logConstrainedSetProb = std::log(constrainedSetProb);
-            const std::vector<Likelihood>& pamVec = probAnyMissing_.vectorized(prVec, MAX_STRAINS);
-            for (unsigned int numStrains = 1; numStrains <= MAX_STRAINS; ++numStrains) {
-                const unsigned int idx = numStrains - 1;
-                if (logLikelihoods[idx] == -std::numeric_limits<Likelihood>::infinity()) {
-                    continue;
-                }
-                logLikelihoods[idx] += pamVec[idx] >= 1.0 ? -std::numeric_limits<Likelihood>::infinity() : std::log(1.0 - pamVec[idx]) + logConstrainedSetProb * numStrains;
+    template<unsigned int MAX_PARENTS, unsigned int MAX_STRAINS, typename SourceTransmissionProcessImpl, typename ParentSetSizePriorImpl>
+    template<typename CalculateLocus>
+    auto MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::sumLocusStrainLogLikelihoods(const std::vector<p_Locus>& loci, CalculateLocus&& calculateLocus) -> StrainLogLikelihoods {
+        StrainLogLikelihoods logLikelihoods{0};
+        for (const auto& locus : loci) {
+            const auto locusLogLikelihoods = calculateLocus(locus);
+            // An impossible locus makes every number of strains impossible
+            if (std::ranges::all_of(locusLogLikelihoods, [](const Likelihood l) { return l == -std::numeric_limits<Likelihood>::infinity(); })) {
+                logLikelihoods.fill(-std::numeric_limits<Likelihood>::infinity());
+                return logLikelihoods;
             }
+            addLocusStrainLogLikelihoods(locusLogLikelihoods, logLikelihoods);
         }
+        return logLikelihoods;
+    }
 
-        Likelihood maxLl = -std::numeric_limits<Likelihood>::infinity();
-        for (unsigned int numStrains = numParents; numStrains <= MAX_STRAINS; ++numStrains) {
-            const unsigned int idx = numStrains - 1;
-            // Add the probability of the number of strains
-            if (logLikelihoods[idx] == -std::numeric_limits<Likelihood>::infinity()) {
-                continue;
-            }
-            logLikelihoods[idx] += this->probNumStrains(numStrains, numParents);
-            maxLl = std::max(maxLl, logLikelihoods[idx]);
-        }
+    template<unsigned int MAX_PARENTS, unsigned int MAX_STRAINS, typename SourceTransmissionProcessImpl, typename ParentSetSizePriorImpl>
+    template<typename GeneticsImpl, typename ParentRange>
+    Likelihood MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::calculateLogLikelihood(const InfectionImpl<GeneticsImpl>& infection, const ParentRange& parentSet, const p_ParentSetSizePrior& psp) {
+        return combineLogLikelihood(calculateStrainLogLikelihoods(infection, parentSet), parentSet.size(), psp);
+    }
 
-        Likelihood llik = core::utils::logSumExpKnownMax(logLikelihoods.begin(), logLikelihoods.end(), maxLl) + stp->value();
+    template<unsigned int MAX_PARENTS, unsigned int MAX_STRAINS, typename SourceTransmissionProcessImpl, typename ParentSetSizePriorImpl>
+    template<typename GeneticsImpl, typename ParentRange>
+    Likelihood MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::calculateLogLikelihood(
+        const InfectionImpl<GeneticsImpl>& infection,
+        const InfectionImpl<GeneticsImpl>& latentParent,
+        const ParentRange& parentSet,
+        const p_SourceTransmissionProcess& stp,
+        const p_ParentSetSizePrior& psp) {
+        return combineLogLikelihood(calculateStrainLogLikelihoods(infection, latentParent, parentSet), parentSet.size() + 1, stp, psp);
+    }
 
-        // Add the prior on the number of parents
-        llik += psp->value()(numParents);
-        return llik;
+    template<unsigned int MAX_PARENTS, unsigned int MAX_STRAINS, typename SourceTransmissionProcessImpl, typename ParentSetSizePriorImpl>
+    template<typename GeneticsImpl>
+    Likelihood MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionProcessImpl, ParentSetSizePriorImpl>::calculateLogLikelihood(
+            const InfectionImpl<GeneticsImpl>& infection,
+            const InfectionImpl<GeneticsImpl>& latentParent,
+            const p_SourceTransmissionProcess& stp,
+            const p_ParentSetSizePrior& psp
+            ) {
+        return combineLogLikelihood(calculateStrainLogLikelihoods(infection, latentParent), 1, stp, psp);
     }
 
 }// namespace transmission_nets::model::transmission_process
@@ -0,0 +1,130 @@
+#ifndef TRANSMISSION_NETWORKS_APP_MULTINOMIALSOURCELOCUSCACHE_H
+#define TRANSMISSION_NETWORKS_APP_MULTINOMIALSOURCELOCUSCACHE_H
+
+#include "core/computation/PartialLikelihood.h"
+#include "core/containers/Locus.h"
+
+#include <boost/container/flat_map.hpp>
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+
+namespace transmission_nets::model::transmission_process {
+
+    /*
+     * Per locus memo of source genotype log likelihoods across COI, shared by all source transmission processes of a model.
+     * The likelihood of a genotype at a locus depends only on the genotype and the allele frequencies at that locus, so each
+     * distinct genotype is evaluated once per allele frequency update no matter how many infections carry it.
+     *
+     * Entries are tagged with the allele frequency version they were computed under. A change to the allele frequencies
+     * moves the locus to a fresh version, and a restore returns it to the version that was saved, which revives any entries
+     * computed before the rejected proposal that have not been overwritten since. Once a new version is accepted no
+     * earlier version can be restored, so the entries computed under them are dropped.
+     *
+     * Lookups and inserts may come from source transmission processes evaluated concurrently, so entries are copied out
+     * under a shared lock and inserted under an exclusive one.
+     */
+    template<typename AlleleFrequencyContainer, typename GeneticsImpl, int MAX_COI>
+    class MultinomialSourceLocusCache {
+        using Likelihood = core::computation::Likelihood;
+
+    public:
+        using LocusLogLikelihoods = std::array<Likelihood, MAX_COI + 1>;
+
+        explicit MultinomialSourceLocusCache(std::shared_ptr<AlleleFrequencyContainer> alleleFrequenciesContainer);
+
+        /**
+         * @brief Copies the cached log likelihoods of the genotype at the locus to llik, returns false if they must be
+         * (re)calculated.
+         */
+        [[nodiscard]] bool find(const std::shared_ptr<core::containers::Locus>& locus, const GeneticsImpl& genotype, LocusLogLikelihoods& llik) const;
+
+        void insert(const std::shared_ptr<core::containers::Locus>& locus, const GeneticsImpl& genotype, const LocusLogLikelihoods& llik);
+
+        [[nodiscard]] std::size_t version(const std::shared_ptr<core::containers::Locus>& locus) const {
+            return tables_.at(locus).version;
+        }
+
+        [[nodiscard]] std::size_t size(const std::shared_ptr<core::containers::Locus>& locus) const {
+            return tables_.at(locus).entries.size();
+        }
+
+    private:
+        struct Entry {
+            LocusLogLikelihoods llik;
+            std::size_t version;
+        };
+
+        struct LocusTable {
+            std::unordered_map<GeneticsImpl, Entry> entries{};
+            std::size_t version = 0;
+            // Version the entries were last pruned to
+            std::size_t prunedVersion = 0;
+            std::vector<std::size_t> savedVersions{};
+        };
+
+        boost::container::flat_map<std::shared_ptr<core::containers::Locus>, LocusTable> tables_{};
+        // versions are unique across updates so that a version is never reused after a restore
+        std::size_t nextVersion_ = 0;
+        mutable std::shared_mutex entriesMutex_{};
+    };
+
+    template<typename AlleleFrequencyContainer, typename GeneticsImpl, int MAX_COI>
+    MultinomialSourceLocusCache<AlleleFrequencyContainer, GeneticsImpl, MAX_COI>::MultinomialSourceLocusCache(std::shared_ptr<AlleleFrequencyContainer> alleleFrequenciesContainer) {
+        for (const auto& locus : alleleFrequenciesContainer->loci) {
+            tables_[locus].version       = nextVersion_++;
+            tables_[locus].prunedVersion = tables_[locus].version;
+
+            auto alleleFrequencies = alleleFrequenciesContainer->alleleFrequencies(locus);
+            alleleFrequencies->add_post_change_listener([=, this]() {
+                tables_.at(locus).version = nextVersion_++;
+            });
+            alleleFrequencies->add_save_state_listener([=, this]([[maybe_unused]] int savedStateId) {
+                auto& table = tables_.at(locus);
+                table.savedVersions.push_back(table.version);
+            });
+            alleleFrequencies->add_restore_state_listener([=, this]([[maybe_unused]] int savedStateId) {
+                auto& table   = tables_.at(locus);
+                table.version = table.savedVersions.back();
+                table.savedVersions.pop_back();
+            });
+            alleleFrequencies->add_accept_state_listener([=, this]() {
+                auto& table = tables_.at(locus);
+                table.savedVersions.clear();
+                if (table.prunedVersion != table.version) {
+                    std::unique_lock lock(entriesMutex_);
+                    std::erase_if(table.entries, [&](const auto& entry) { return entry.second.version != table.version; });
+                    table.prunedVersion = table.version;
+                }
+            });
+        }
+    }
+
+    template<typename AlleleFrequencyContainer, typename GeneticsImpl, int MAX_COI>
+    auto MultinomialSourceLocusCache<AlleleFrequencyContainer, GeneticsImpl, MAX_COI>::find(const std::shared_ptr<core::containers::Locus>& locus, const GeneticsImpl& genotype, LocusLogLikelihoods& llik) const -> bool {
+        const auto& table = tables_.at(locus);
+        std::shared_lock lock(entriesMutex_);
+        const auto it = table.entries.find(genotype);
+        if (it == table.entries.end() or it->second.version != table.version) {
+            return false;
+        }
+        llik = it->second.llik;
+        return true;
+    }
+
+    template<typename AlleleFrequencyContainer, typename GeneticsImpl, int MAX_COI>
+    void MultinomialSourceLocusCache<AlleleFrequencyContainer, GeneticsImpl, MAX_COI>::insert(const std::shared_ptr<core::containers::Locus>& locus, const GeneticsImpl& genotype, const LocusLogLikelihoods& llik) {
+        auto& table = tables_.at(locus);
+        std::unique_lock lock(entriesMutex_);
+        table.entries.insert_or_assign(genotype, Entry{llik, table.version});
+    }
+
+}// namespace transmission_nets::model::transmission_process
+
+
+#endif//TRANSMISSION_NETWORKS_APP_MULTINOMIALSOURCELOCUSCACHE_H
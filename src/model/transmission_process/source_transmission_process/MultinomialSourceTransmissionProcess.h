@@ -15,11 +15,14 @@
 #include "core/utils/ProbAnyMissing.h"
 #include "core/utils/numerics.h"
 
-#include <boost/container/flat_map.hpp>
+#include "model/transmission_process/source_transmission_process/MultinomialSourceLocusCache.h"
+
 #include <boost/container/flat_set.hpp>
 
+#include <array>
 #include <cmath>
 #include <functional>
+#include <type_traits>
 #include <utility>
 
 
@@ -29,11 +32,18 @@ namespace transmission_nets::model::transmission_process {
     class MultinomialSourceTransmissionProcess : public core::computation::PartialLikelihood {
 
     public:
+        using GeneticsImpl = std::remove_cvref_t<decltype(std::declval<GenotypeParameterMap>().begin()->second->value())>;
+        using LocusCache   = MultinomialSourceLocusCache<AlleleFrequencyContainer, GeneticsImpl, MAX_COI>;
+
+        /**
+         * @param locusCache Optional per locus memo shared with the other source processes over the same allele frequencies
+         */
         MultinomialSourceTransmissionProcess(std::shared_ptr<COIProbabilityImpl> coiProb,
                                              std::shared_ptr<AlleleFrequencyContainer> alleleFrequenciesContainer,
                                              std::vector<std::shared_ptr<core::containers::Locus>> loci,
                                              const GenotypeParameterMap& genetics,
-                                             bool null_model = false);
+                                             bool null_model = false,
+                                             std::shared_ptr<LocusCache> locusCache = nullptr);
 
         Likelihood value() override;
         Likelihood peek() noexcept override;
@@ -44,7 +54,9 @@ namespace transmission_nets::model::transmission_process {
         friend class Cacheable<MultinomialSourceTransmissionProcess>;
         friend class Checkpointable<MultinomialSourceTransmissionProcess, double>;
 
-        void calculateLocusLogLikelihood(std::shared_ptr<core::containers::Locus> locus);
+        void calculateLocusLogLikelihood(std::size_t locusIdx, bool useLocusCache = true);
+        void sumLocusLogLikelihoods();
+        Likelihood combineCOI();
         void postSaveState(int savedStateId);
         void postAcceptState();
         void postRestoreState(int savedStateId);
@@ -52,14 +64,16 @@ namespace transmission_nets::model::transmission_process {
         std::shared_ptr<COIProbabilityImpl> coiProb_;
         std::shared_ptr<AlleleFrequencyContainer> alleleFrequenciesContainer_;
         std::vector<std::shared_ptr<core::containers::Locus>> loci_{};
-        GenotypeParameterMap genetics_;
+        // Genotype at each locus, in the order of loci_
+        std::vector<typename GenotypeParameterMap::mapped_type> genotypes_{};
+        std::shared_ptr<LocusCache> locusCache_;
 
         // update alleleFrequencies -> update estimates at locus
         // update founder -> update estimates at locus
-        // update COI -> update estimates across loci
+        // update COI -> reweight the locus summed estimates, no locus is recomputed
 
-        boost::container::flat_map<std::shared_ptr<core::containers::Locus>, int> locusIdxMap_{};
-        boost::container::flat_set<std::shared_ptr<core::containers::Locus>> dirtyLoci_{};
+        // Loci are referred to by their position in loci_, which is also their row in llikMatrix_
+        boost::container::flat_set<std::size_t> dirtyLoci_{};
 
 
         // loci independent conditional on COI
@@ -68,12 +82,16 @@ namespace transmission_nets::model::transmission_process {
         // buffers for calculations
         std::vector<Likelihood> coiPartialLlik_{};
         std::vector<Likelihood> prVec_{};
+        typename LocusCache::LocusLogLikelihoods locusLlikBuffer_{};
+        // pamBuffer_[coi] is the probability that one or more alleles are missed after coi draws
+        std::array<Likelihood, MAX_COI + 1> pamBuffer_{};
 
         // stateful -- must be cached
-        std::vector<Likelihood> locusLlikBuffer_{};
+        // llikMatrix_ is independent of the COI distribution, lociLlik_ is its sum across loci
         std::vector<Likelihood> llikMatrix_{};
-        std::vector<std::vector<Likelihood>> locusLlikBufferCache_{};
+        std::vector<Likelihood> lociLlik_{};
         std::vector<std::vector<Likelihood>> llikMatrixCache_{};
+        std::vector<std::vector<Likelihood>> lociLlikCache_{};
 
         std::vector<Likelihood> tmpCalculationVec_{};
 
@@ -89,36 +107,36 @@ namespace transmission_nets::model::transmission_process {
             std::shared_ptr<AlleleFrequencyContainer> alleleFrequenciesContainer,
             std::vector<std::shared_ptr<core::containers::Locus>> loci,
             const GenotypeParameterMap& genetics,
-            const bool null_model) : coiProb_(std::move(coiProb)), alleleFrequenciesContainer_(std::move(alleleFrequenciesContainer)), loci_(std::move(loci)), genetics_(genetics), null_model_(null_model) {
+            const bool null_model,
+            std::shared_ptr<LocusCache> locusCache) : coiProb_(std::move(coiProb)), alleleFrequenciesContainer_(std::move(alleleFrequenciesContainer)), loci_(std::move(loci)), locusCache_(std::move(locusCache)), null_model_(null_model) {
         value_ = 0;
         totalLoci_ = alleleFrequenciesContainer_->totalLoci();
 
         llikMatrix_.resize((MAX_COI + 1) * totalLoci_);
+        lociLlik_.resize(MAX_COI + 1);
         coiPartialLlik_.resize(MAX_COI + 1);
-        locusLlikBuffer_.resize(MAX_COI + 1);
 
         coiProb_->registerCacheableCheckpointTarget(this);
         coiProb_->add_set_dirty_listener([=, this]() {
             this->setDirty();
-            this->dirtyLoci_.insert(loci_.begin(), loci_.end());
         });
 
-        int idx = 0;
-        for (const auto& locus : loci_) {
-            this->dirtyLoci_.insert(locus);
-            locusIdxMap_[locus] = idx;
-            idx++;
+        genotypes_.reserve(loci_.size());
+        for (std::size_t idx = 0; idx < loci_.size(); ++idx) {
+            const auto& locus = loci_[idx];
+            this->dirtyLoci_.insert(idx);
 
             alleleFrequenciesContainer_->alleleFrequencies(locus)->registerCacheableCheckpointTarget(this);
             alleleFrequenciesContainer_->alleleFrequencies(locus)->add_post_change_listener([=, this]() {
                 this->setDirty();
-                this->dirtyLoci_.insert(locus);
+                this->dirtyLoci_.insert(idx);
             });
 
-            genetics_.at(locus)->registerCacheableCheckpointTarget(this);
-            genetics_.at(locus)->add_post_change_listener([=, this]() {
+            genotypes_.push_back(genetics.at(locus));
+            genotypes_.back()->registerCacheableCheckpointTarget(this);
+            genotypes_.back()->add_post_change_listener([=, this]() {
                 this->setDirty();
-                this->dirtyLoci_.insert(locus);
+                this->dirtyLoci_.insert(idx);
             });
         }
 
@@ -138,40 +156,26 @@ namespace transmission_nets::model::transmission_process {
             return this->value_;
         }
         if (this->isDirty()) {
-            for (const auto& locus : dirtyLoci_) {
-                this->calculateLocusLogLikelihood(locus);
-                std::ranges::copy(locusLlikBuffer_, llikMatrix_.begin() + locusIdxMap_[locus] * (MAX_COI + 1));
-            }
-            dirtyLoci_.clear();
-
-            tmpCalculationVec_.clear();
-
-            std::ranges::fill(coiPartialLlik_, 0.0);
-            for (int k = 0; k < MAX_COI + 1; ++k) {
-                coiPartialLlik_[k] += coiProb_->value()[k];
-            }
-
-            for (int j = 0; j < totalLoci_; j++) {
-                for (int i = 0; i < MAX_COI + 1; i++) {
-                    coiPartialLlik_[i] += llikMatrix_[j * (MAX_COI + 1) + i];
+            // A change to the COI distribution alone leaves dirtyLoci_ empty and only the final combination is redone
+            if (!dirtyLoci_.empty()) {
+                for (const auto locusIdx : dirtyLoci_) {
+                    this->calculateLocusLogLikelihood(locusIdx);
+                    std::ranges::copy(locusLlikBuffer_, llikMatrix_.begin() + locusIdx * (MAX_COI + 1));
                 }
+                dirtyLoci_.clear();
+                sumLocusLogLikelihoods();
             }
 
-
-            for (int l = 0; l < MAX_COI + 1; ++l) {
-                tmpCalculationVec_.push_back(coiPartialLlik_[l]);
-            }
-
-            this->value_ = core::utils::logSumExp(tmpCalculationVec_);
+            this->value_ = combineCOI();
 
             if (std::isnan(this->value_) or this->value_ <= -std::numeric_limits<double>::infinity()) {
                 fmt::print("NAN in MultinomialSourceTransmissionProcess::value()\n");
                 fmt::print("\ttmpCalculationVec_ = {}\n", core::io::serialize(tmpCalculationVec_));
                 fmt::print("\tcoiPartialLlik_ = {}\n", core::io::serialize(coiPartialLlik_));
                 fmt::print("Allele frequencies:\n");
-                for (const auto& locus : loci_) {
-                    fmt::print("\tlocus {} = {}\n", locus->label, core::io::serialize(alleleFrequenciesContainer_->alleleFrequencies(locus)->value()));
-                    fmt::print("\tgenotype = {}\n", genetics_.at(locus)->value().allelesStr());
+                for (std::size_t idx = 0; idx < loci_.size(); ++idx) {
+                    fmt::print("\tlocus {} = {}\n", loci_[idx]->label, core::io::serialize(alleleFrequenciesContainer_->alleleFrequencies(loci_[idx])->value()));
+                    fmt::print("\tgenotype = {}\n", genotypes_[idx]->value().allelesStr());
                 }
                 fmt::print("{}\n", core::io::serialize_matrix(llikMatrix_, totalLoci_, MAX_COI + 1));
                 this->value_ = -std::numeric_limits<double>::infinity();
@@ -202,29 +206,34 @@ namespace transmission_nets::model::transmission_process {
 
     template<typename COIProbabilityImpl, typename AlleleFrequencyContainer, typename InfectionEventImpl, int MAX_COI>
     Likelihood MultinomialSourceTransmissionProcess<COIProbabilityImpl, AlleleFrequencyContainer, InfectionEventImpl, MAX_COI>::validate() {
-        for (const auto& [locus, idx] : locusIdxMap_) {
-            this->calculateLocusLogLikelihood(locus);
+        for (std::size_t idx = 0; idx < loci_.size(); ++idx) {
+            this->calculateLocusLogLikelihood(idx, false);
             std::ranges::copy(locusLlikBuffer_, llikMatrix_.begin() + (idx * (MAX_COI + 1)));
         }
 
         //        dirtyLoci_.clear();
-        tmpCalculationVec_.clear();
-
-        std::ranges::fill(coiPartialLlik_, 0.0);
-        for (int k = 0; k < MAX_COI + 1; ++k) {
-            coiPartialLlik_[k] += coiProb_->value()[k];
-        }
+        sumLocusLogLikelihoods();
+        return combineCOI();
+    }
 
+    template<typename COIProbabilityImpl, typename AlleleFrequencyContainer, typename InfectionEventImpl, int MAX_COI>
+    void MultinomialSourceTransmissionProcess<COIProbabilityImpl, AlleleFrequencyContainer, InfectionEventImpl, MAX_COI>::sumLocusLogLikelihoods() {
+        std::ranges::fill(lociLlik_, 0.0);
         for (int j = 0; j < totalLoci_; j++) {
             for (int i = 0; i < MAX_COI + 1; i++) {
-                coiPartialLlik_[i] += llikMatrix_[j * (MAX_COI + 1) + i];
+                lociLlik_[i] += llikMatrix_[j * (MAX_COI + 1) + i];
             }
         }
+    }
 
-        for (int l = 0; l < MAX_COI + 1; ++l) {
-            tmpCalculationVec_.push_back(coiPartialLlik_[l]);
+    template<typename COIProbabilityImpl, typename AlleleFrequencyContainer, typename InfectionEventImpl, int MAX_COI>
+    Likelihood MultinomialSourceTransmissionProcess<COIProbabilityImpl, AlleleFrequencyContainer, InfectionEventImpl, MAX_COI>::combineCOI() {
+        const auto& coiLlik = coiProb_->value();
+        tmpCalculationVec_.clear();
+        for (int k = 0; k < MAX_COI + 1; ++k) {
+            coiPartialLlik_[k] = coiLlik[k] + lociLlik_[k];
+            tmpCalculationVec_.push_back(coiPartialLlik_[k]);
         }
-
         return core::utils::logSumExp(tmpCalculationVec_);
     }
 
@@ -236,19 +245,24 @@ namespace transmission_nets::model::transmission_process {
 
 
     template<typename COIProbabilityImpl, typename AlleleFrequencyContainer, typename InfectionEventImpl, int MAX_COI>
-    __attribute__((flatten)) void MultinomialSourceTransmissionProcess<COIProbabilityImpl, AlleleFrequencyContainer, InfectionEventImpl, MAX_COI>::calculateLocusLogLikelihood(const std::shared_ptr<core::containers::Locus> locus) {
+    __attribute__((flatten)) void MultinomialSourceTransmissionProcess<COIProbabilityImpl, AlleleFrequencyContainer, InfectionEventImpl, MAX_COI>::calculateLocusLogLikelihood(const std::size_t locusIdx, const bool useLocusCache) {
+        const auto& locus    = loci_[locusIdx];
+        const auto& genotype = genotypes_[locusIdx]->value();
+        if (locusCache_ and useLocusCache) {
+            if (locusCache_->find(locus, genotype, locusLlikBuffer_)) {
+                return;
+            }
+        }
+
         const auto& alleleFreqs = alleleFrequenciesContainer_->alleleFrequencies(locus)->value();
-        const auto& genotype = genetics_.at(locus)->value();
         double constrainedSetProb = 0.0;
 
+        // Only the alleles present are visited, so this costs O(alleles present) rather than O(alleles at the locus)
         prVec_.clear();
-        prVec_.reserve(alleleFreqs.totalElements());
-        for (size_t j = 0; j < alleleFreqs.totalElements(); ++j) {
-            if (genotype.allele(j)) {
-                prVec_.push_back(alleleFreqs.frequencies(j));
-                constrainedSetProb += alleleFreqs.frequencies(j);
-            }
-        }
+        genotype.forEachAllele([&](const std::size_t j) {
+            prVec_.push_back(alleleFreqs.frequencies(j));
+            constrainedSetProb += alleleFreqs.frequencies(j);
+        });
 
 
         if (constrainedSetProb > 0) {
@@ -259,9 +273,12 @@ namespace transmission_nets::model::transmission_process {
 
             const double logConstrainedSetProb = std::log(constrainedSetProb);
 
+            // Prob that after `coi` draws 1 or more alleles are not drawn, for every coi in a single pass
+            pamBuffer_[0] = prVec_.empty() ? 0.0 : 1.0;
+            probAnyMissing_.vectorized(prVec_.data(), prVec_.size(), MAX_COI, pamBuffer_.data() + 1);
+
             for (unsigned int coi = 0; coi <= MAX_COI; coi++) {
-                // Prob that after `coi` draws 1 or more alleles are not drawn
-                double pam = probAnyMissing_(prVec_, coi);
+                const double pam = pamBuffer_[coi];
 
                 // prob that after `coi` draws all alleles are drawn at least once conditional on all draws come from the constrained set.
                 if (pam >= 1 and coi >= prVec_.size()) {
@@ -282,26 +299,30 @@ namespace transmission_nets::model::transmission_process {
         } else {
             std::ranges::fill(locusLlikBuffer_, -std::numeric_limits<Likelihood>::infinity());
         }
+
+        if (locusCache_ and useLocusCache) {
+            locusCache_->insert(locus, genotype, locusLlikBuffer_);
+        }
     }
 
     template<typename COIProbabilityImpl, typename AlleleFrequencyContainer, typename InfectionEventImpl, int MAX_COI>
     void MultinomialSourceTransmissionProcess<COIProbabilityImpl, AlleleFrequencyContainer, InfectionEventImpl, MAX_COI>::postSaveState([[maybe_unused]] int savedStateId) {
-        locusLlikBufferCache_.emplace_back(locusLlikBuffer_);
         llikMatrixCache_.emplace_back(llikMatrix_);
+        lociLlikCache_.emplace_back(lociLlik_);
     }
 
     template<typename COIProbabilityImpl, typename AlleleFrequencyContainer, typename InfectionEventImpl, int MAX_COI>
     void MultinomialSourceTransmissionProcess<COIProbabilityImpl, AlleleFrequencyContainer, InfectionEventImpl, MAX_COI>::postAcceptState() {
-        locusLlikBufferCache_.clear();
         llikMatrixCache_.clear();
+        lociLlikCache_.clear();
     }
 
     template<typename COIProbabilityImpl, typename AlleleFrequencyContainer, typename InfectionEventImpl, int MAX_COI>
     void MultinomialSourceTransmissionProcess<COIProbabilityImpl, AlleleFrequencyContainer, InfectionEventImpl, MAX_COI>::postRestoreState([[maybe_unused]] int savedStateId) {
-        locusLlikBuffer_ = std::move(locusLlikBufferCache_.back());
-        locusLlikBufferCache_.pop_back();
         llikMatrix_ = std::move(llikMatrixCache_.back());
         llikMatrixCache_.pop_back();
+        lociLlik_ = std::move(lociLlikCache_.back());
+        lociLlikCache_.pop_back();
     }
 }// namespace transmission_nets::model::transmission_process
 
@@ -0,0 +1,75 @@
+#include "gtest/gtest.h"
+
+#include "core/parameters/Parameter.h"
+
+#include <vector>
+
+using namespace transmission_nets::core::parameters;
+
+TEST(CheckpointableTest, DeferredRestoreAfterChange) {
+    static_assert(transmission_nets::core::abstract::DefersCheckpoints<Parameter<std::vector<int>>>);
+
+    Parameter<std::vector<int>> p(std::vector<int>{1, 2, 3});
+    p.saveState(1);
+    p.setValue({4});
+    p.setValue({5, 6});
+    p.restoreState(1);
+    EXPECT_EQ(p.value(), (std::vector<int>{1, 2, 3}));
+    EXPECT_FALSE(p.isSaved());
+
+    // Restoring a save that was never followed by a change keeps the value
+    p.saveState(1);
+    p.restoreState(1);
+    EXPECT_EQ(p.value(), (std::vector<int>{1, 2, 3}));
+
+    p.saveState(1);
+    p.setValue({7});
+    p.acceptState();
+    EXPECT_EQ(p.value(), (std::vector<int>{7}));
+    EXPECT_FALSE(p.isSaved());
+}
+
+TEST(CheckpointableTest, DeferredNestedSaves) {
+    Parameter<std::vector<int>> p(std::vector<int>{1});
+
+    // Changed only after the inner save, the outer checkpoint is never filled
+    p.saveState(1);
+    p.saveState(2);
+    p.setValue({2});
+    p.restoreState(2);
+    EXPECT_EQ(p.value(), (std::vector<int>{1}));
+    p.restoreState(1);
+    EXPECT_EQ(p.value(), (std::vector<int>{1}));
+
+    // Changed under both saves, each restore returns to the value at its own save
+    p.saveState(1);
+    p.setValue({2});
+    p.saveState(2);
+    p.setValue({3});
+    p.setValue({4});
+    p.restoreState(2);
+    EXPECT_EQ(p.value(), (std::vector<int>{2}));
+    p.setValue({5});
+    p.restoreState(1);
+    EXPECT_EQ(p.value(), (std::vector<int>{1}));
+    EXPECT_FALSE(p.isSaved());
+}
+
+namespace {
+    // Changes value_ without checkpointBeforeChange, breaking the deferred checkpoint contract
+    class UncheckedParameter : public Parameter<std::vector<int>> {
+    public:
+        using Parameter::Parameter;
+
+        void setValueUnchecked(std::vector<int> value) {
+            value_ = std::move(value);
+        }
+    };
+}// namespace
+
+TEST(CheckpointableDeathTest, DeferredChangeWithoutCheckpoint) {
+    UncheckedParameter p(std::vector<int>{1});
+    p.saveState(1);
+    p.setValueUnchecked({2});
+    EXPECT_DEBUG_DEATH(p.restoreState(1), "");
+}
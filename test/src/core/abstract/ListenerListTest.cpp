@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+
+#include "core/abstract/observables/InlineCallback.h"
+#include "core/abstract/observables/ListenerList.h"
+#include "core/abstract/observables/Observable.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace transmission_nets::core::abstract;
+
+TEST(InlineCallbackTest, StoresSmallAndLargeCallables) {
+    auto counter = std::make_shared<int>(0);
+    InlineCallback<void(int)> small([counter](int x) { *counter += x; });
+
+    std::array<int, 32> offsets{};
+    offsets.fill(1);
+    InlineCallback<void(int)> large([counter, offsets](int x) { *counter += x + offsets[31]; });
+
+    small(2);
+    large(2);
+    EXPECT_EQ(*counter, 5);
+
+    // Copies share nothing but the captured state
+    auto smallCopy = small;
+    auto largeCopy = large;
+    auto moved     = std::move(large);
+    smallCopy(1);
+    largeCopy(1);
+    moved(1);
+    EXPECT_EQ(*counter, 10);
+    EXPECT_FALSE(large);
+
+    small = moved;
+    small(0);
+    EXPECT_EQ(*counter, 11);
+    EXPECT_EQ(counter.use_count(), 5);
+}
+
+TEST(ListenerListTest, DispatchesInRegistrationOrder) {
+    ListenerList<void(int)> listeners;
+    std::vector<int> calls;
+    for (ListenerId_t id = 1; id <= 3; ++id) {
+        listeners.add(id, [&calls, id](int x) { calls.push_back(static_cast<int>(id) * x); });
+    }
+    listeners.dispatch(10);
+    EXPECT_EQ(calls, (std::vector<int>{10, 20, 30}));
+
+    EXPECT_TRUE(listeners.remove(2));
+    EXPECT_FALSE(listeners.remove(2));
+    calls.clear();
+    listeners.dispatch(1);
+    EXPECT_EQ(calls, (std::vector<int>{1, 3}));
+}
+
+TEST(ListenerListTest, DefersChangesDuringDispatch) {
+    ListenerList<void()> listeners;
+    std::vector<int> calls;
+    bool nested = false;
+
+    // The first listener removes the third and adds a fourth while the event is being dispatched
+    listeners.add(1, [&]() {
+        calls.push_back(1);
+        if (listeners.remove(3)) {
+            listeners.add(4, [&]() { calls.push_back(4); });
+        }
+    });
+    listeners.add(2, [&]() {
+        calls.push_back(2);
+        // Nested dispatches see the same listeners
+        if (!nested) {
+            nested = true;
+            listeners.dispatch();
+        }
+    });
+    listeners.add(3, [&]() { calls.push_back(3); });
+
+    listeners.dispatch();
+    EXPECT_EQ(calls, (std::vector<int>{1, 2, 1, 2}));
+    EXPECT_EQ(listeners.size(), 3u);
+
+    calls.clear();
+    listeners.dispatch();
+    EXPECT_EQ(calls, (std::vector<int>{1, 2, 4}));
+
+    // A listener added and removed within the same dispatch never runs
+    listeners.add(5, [&]() {
+        listeners.add(6, [&]() { calls.push_back(6); });
+        listeners.remove(6);
+    });
+    calls.clear();
+    listeners.dispatch();
+    listeners.dispatch();
+    EXPECT_EQ(calls, (std::vector<int>{1, 2, 4, 1, 2, 4}));
+}
+
+namespace transmission_nets::core::abstract {
+    class KeyedSource : public Observable<KeyedSource> {
+        using Callback = std::function<void(int)>;
+        CREATE_KEYED_EVENT(fired, int, Callback)
+    };
+}// namespace transmission_nets::core::abstract
+
+TEST(ListenerListTest, RegistersKeysDuringKeyedDispatch) {
+    KeyedSource source;
+    source.register_fired_listener_key(0);
+    std::vector<int> calls;
+
+    // Registering keys grows the map while the listeners of key 0 are being dispatched
+    source.add_keyed_fired_listener(0, [&](int x) {
+        calls.push_back(x);
+        for (int key = 1; key <= 64; ++key) {
+            source.register_fired_listener_key(key);
+        }
+        source.add_keyed_fired_listener(64, [&](int y) { calls.push_back(y); });
+    });
+    source.add_keyed_fired_listener(0, [&](int x) { calls.push_back(x + 1); });
+
+    source.keyed_notify_fired(0, 10);
+    EXPECT_EQ(calls, (std::vector<int>{10, 11}));
+
+    calls.clear();
+    source.keyed_notify_fired(64, 20);
+    EXPECT_EQ(calls, (std::vector<int>{20}));
+    EXPECT_EQ(source.keyed_fired_listener_count(0), 2u);
+}
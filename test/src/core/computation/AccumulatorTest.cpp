@@ -0,0 +1,119 @@
+#include "gtest/gtest.h"
+
+#include "core/computation/Accumulator.h"
+#include "core/computation/PartialLikelihood.h"
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace transmission_nets::core::computation;
+
+namespace {
+    class ConstantLikelihood : public PartialLikelihood {
+    public:
+        explicit ConstantLikelihood(const Likelihood value) : next_(value) {
+            this->setDirty();
+        }
+
+        void set(const Likelihood value) {
+            next_ = value;
+            this->setDirty();
+        }
+
+        Likelihood value() override {
+            if (this->isDirty()) {
+                value_ = next_;
+                this->setClean();
+            }
+            return value_;
+        }
+
+        std::string identifier() override {
+            return "ConstantLikelihood";
+        }
+
+    private:
+        Likelihood next_;
+    };
+}// namespace
+
+TEST(AccumulatorTest, DirtyTargetCountedOnce) {
+    Accumulator<PartialLikelihood, Likelihood> acc;
+    auto a = std::make_shared<ConstantLikelihood>(-1.0);
+    auto b = std::make_shared<ConstantLikelihood>(-2.0);
+    acc.addTarget(a);
+    acc.addTarget(b);
+    EXPECT_DOUBLE_EQ(acc.value(), -3.0);
+
+    a->set(-4.0);
+    a->set(-5.0);
+    b->set(-1.0);
+    EXPECT_TRUE(acc.isDirty());
+    EXPECT_DOUBLE_EQ(acc.value(), -6.0);
+    EXPECT_FALSE(acc.isDirty());
+
+    acc.saveState(1);
+    a->set(-10.0);
+    EXPECT_DOUBLE_EQ(acc.value(), -11.0);
+    acc.restoreState(1);
+    EXPECT_DOUBLE_EQ(acc.value(), -6.0);
+}
+
+TEST(AccumulatorTest, CompensatedTotalDoesNotDrift) {
+    constexpr int TOTAL_TARGETS = 100;
+
+    Accumulator<PartialLikelihood, Likelihood> acc;
+    acc.addTarget(std::make_shared<ConstantLikelihood>(-1e8));
+    std::vector<std::shared_ptr<ConstantLikelihood>> targets{};
+    for (int i = 0; i < TOTAL_TARGETS; ++i) {
+        targets.push_back(std::make_shared<ConstantLikelihood>(-0.1));
+        acc.addTarget(targets.back());
+    }
+    acc.value();
+
+    // Uncompensated, the rounding of each subtract and add update accumulates to about 1e-3 over this run
+    for (int i = 0; i < 1'000'000; ++i) {
+        targets[(i * 37) % TOTAL_TARGETS]->set(-1e6 * std::fmod(i * 0.6180339887, 1.0));
+        acc.value();
+    }
+
+    long double exact = -1e8;
+    for (const auto& target : targets) {
+        exact += target->value();
+    }
+    EXPECT_NEAR(acc.value(), static_cast<double>(exact), 1e-7);
+}
+
+TEST(AccumulatorTest, ParallelTotalMatchesSerial) {
+    constexpr int TOTAL_TARGETS = 500;
+
+    Accumulator<PartialLikelihood, Likelihood> serial;
+    Accumulator<PartialLikelihood, Likelihood> parallel;
+    int prepared = 0;
+    parallel.setParallelEvaluation(64, 4, [&]() { prepared++; });
+
+    std::vector<std::shared_ptr<ConstantLikelihood>> serialTargets{};
+    std::vector<std::shared_ptr<ConstantLikelihood>> parallelTargets{};
+    for (int i = 0; i < TOTAL_TARGETS; ++i) {
+        const Likelihood value = -1e3 * std::fmod(i * 0.6180339887, 1.0);
+        serialTargets.push_back(std::make_shared<ConstantLikelihood>(value));
+        parallelTargets.push_back(std::make_shared<ConstantLikelihood>(value));
+        serial.addTarget(serialTargets.back());
+        parallel.addTarget(parallelTargets.back());
+    }
+    EXPECT_EQ(serial.value(), parallel.value());
+    EXPECT_EQ(prepared, 1);
+
+    // Small dirty sets stay serial, large ones are spread over threads, either way the totals agree exactly
+    for (const int changed : {3, 200, TOTAL_TARGETS}) {
+        for (int i = 0; i < changed; ++i) {
+            const Likelihood value = -1e3 * std::fmod((i + changed) * 0.7548776662, 1.0);
+            serialTargets[(i * 7) % TOTAL_TARGETS]->set(value);
+            parallelTargets[(i * 7) % TOTAL_TARGETS]->set(value);
+        }
+        EXPECT_EQ(serial.value(), parallel.value());
+    }
+    EXPECT_EQ(prepared, 3);
+}
@@ -233,4 +233,57 @@ TEST(ObservationTimeDerivedOrderingTest, BaseTest) {
     ASSERT_EQ(ps4.value().size(), 3);
     inf4->infectionDuration()->restoreState(1);
     ASSERT_EQ(ps4.value().size(), 3);
-}
\ No newline at end of file
+}
+TEST(ObservationTimeDerivedOrderingTest, RelocatesWithSingleRangeNotification) {
+    using GeneticsImpl       = AllelesBitSet<32>;
+    using InfectionEventImpl = Infection<GeneticsImpl>;
+
+    std::vector<std::shared_ptr<InfectionEventImpl>> infections;
+    for (int i = 0; i < 6; ++i) {
+        infections.push_back(std::make_shared<InfectionEventImpl>(std::to_string(i), 1000 + 10 * i, false));
+    }
+    auto ord = std::make_shared<ObservationTimeDerivedOrdering<InfectionEventImpl>>(infections);
+    for (std::size_t i = 0; i < infections.size(); ++i) {
+        ASSERT_EQ(ord->position(infections[i]), i);
+    }
+
+    const auto moved = infections[4];
+    std::vector<std::shared_ptr<InfectionEventImpl>> passed;
+    int rangeNotifications = 0;
+    ord->add_keyed_moved_left_past_listener(moved, [&](const auto& elements) {
+        rangeNotifications++;
+        passed.assign(elements.begin(), elements.end());
+    });
+
+    // Moves from the fifth to the second slot, past infections 1, 2 and 3
+    moved->infectionDuration()->saveState(1);
+    moved->infectionDuration()->setValue(moved->infectionDuration()->value() + 35);
+    ASSERT_EQ(rangeNotifications, 1);
+    ASSERT_EQ(passed, std::vector({infections[1], infections[2], infections[3]}));
+
+    const auto view = ord->view();
+    ASSERT_EQ(view[1], moved);
+    for (std::size_t i = 0; i < view.size(); ++i) {
+        ASSERT_EQ(ord->position(view[i]), i);
+    }
+
+    // Restoring the ordering restores the positions as well
+    moved->infectionDuration()->restoreState(1);
+    for (std::size_t i = 0; i < infections.size(); ++i) {
+        ASSERT_EQ(ord->view()[i], infections[i]);
+        ASSERT_EQ(ord->position(infections[i]), i);
+    }
+
+    // Moves at both ends of the ordering under one checkpoint are restored together
+    moved->infectionDuration()->saveState(1);
+    moved->infectionDuration()->setValue(moved->infectionDuration()->value() + 35);
+    infections[0]->infectionDuration()->saveState(1);
+    infections[0]->infectionDuration()->setValue(infections[0]->infectionDuration()->value() - 100);
+    ASSERT_EQ(ord->view().back(), infections[0]);
+    moved->infectionDuration()->restoreState(1);
+    infections[0]->infectionDuration()->restoreState(1);
+    for (std::size_t i = 0; i < infections.size(); ++i) {
+        ASSERT_EQ(ord->view()[i], infections[i]);
+        ASSERT_EQ(ord->position(infections[i]), i);
+    }
+}
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+
+#include "core/containers/AllowedRelationships.h"
+#include "core/containers/Infection.h"
+#include "core/datatypes/Alleles.h"
+#include "core/io/parse_json.h"
+
+#include <vector>
+
+using namespace transmission_nets::core::datatypes;
+using namespace transmission_nets::core::containers;
+
+namespace {
+    using InfectionEvent = Infection<AllelesBitSet<16>>;
+
+    template<typename Span>
+    std::vector<std::shared_ptr<InfectionEvent>> toVector(const Span& span) {
+        return {span.begin(), span.end()};
+    }
+}// namespace
+
+TEST(AllowedRelationshipsTest, StoresBothDirectionsInDeclarationOrder) {
+    auto inf1 = std::make_shared<InfectionEvent>("1", 10.0);
+    auto inf2 = std::make_shared<InfectionEvent>("2", 20.0);
+    auto inf3 = std::make_shared<InfectionEvent>("3", 30.0);
+    auto inf4 = std::make_shared<InfectionEvent>("4", 40.0);
+
+    // (child, parent)
+    const AllowedRelationships<InfectionEvent> relationships({inf1, inf2, inf3, inf4}, {{2, 1}, {2, 0}, {1, 0}, {3, 2}, {3, 0}});
+
+    ASSERT_EQ(relationships.size(), 4);
+    ASSERT_EQ(relationships.index(inf3), 2);
+    ASSERT_EQ(relationships.infectionEvent(3), inf4);
+
+    ASSERT_TRUE(relationships.allowedParents(inf1).empty());
+    ASSERT_EQ(toVector(relationships.allowedParents(inf2)), std::vector({inf1}));
+    ASSERT_EQ(toVector(relationships.allowedParents(inf3)), std::vector({inf2, inf1}));
+    ASSERT_EQ(toVector(relationships.allowedParents(inf4)), std::vector({inf3, inf1}));
+
+    ASSERT_EQ(toVector(relationships.allowedChildren(inf1)), std::vector({inf3, inf2, inf4}));
+    ASSERT_EQ(toVector(relationships.allowedChildren(inf2)), std::vector({inf3}));
+    ASSERT_EQ(toVector(relationships.allowedChildren(inf3)), std::vector({inf4}));
+    ASSERT_TRUE(relationships.allowedChildren(inf4).empty());
+
+    // Infections outside of the relationships, including copies of infections that are part of it, have no relatives
+    auto copy  = std::make_shared<InfectionEvent>(*inf1);
+    auto other = std::make_shared<InfectionEvent>("5", 50.0);
+    ASSERT_EQ(relationships.index(copy), AllowedRelationships<InfectionEvent>::npos);
+    ASSERT_TRUE(relationships.allowedChildren(copy).empty());
+    ASSERT_TRUE(relationships.allowedParents(other).empty());
+}
+
+TEST(AllowedRelationshipsTest, ParsesFromJSON) {
+    auto inf1 = std::make_shared<InfectionEvent>("a", 10.0);
+    auto inf2 = std::make_shared<InfectionEvent>("b", 20.0);
+    auto inf3 = std::make_shared<InfectionEvent>("c", 30.0);
+
+    const auto input = nlohmann::json::parse(R"({"nodes": [
+        {"id": "a", "allowed_parents": []},
+        {"id": "b", "allowed_parents": ["a"]},
+        {"id": "c", "allowed_parents": ["b", "a"]}
+    ]})");
+    const auto relationships = transmission_nets::core::io::parseAllowedParentsFromJSON(input, std::vector({inf1, inf2, inf3}));
+
+    ASSERT_EQ(toVector(relationships->allowedParents(inf3)), std::vector({inf2, inf1}));
+    ASSERT_EQ(toVector(relationships->allowedChildren(inf1)), std::vector({inf2, inf3}));
+    ASSERT_EQ(toVector(relationships->allowedChildren(inf2)), std::vector({inf3}));
+}
+
+TEST(AllowedRelationshipsTest, RejectsUnknownParents) {
+    auto inf1 = std::make_shared<InfectionEvent>("a", 10.0);
+    auto inf2 = std::make_shared<InfectionEvent>("b", 20.0);
+
+    const auto input = nlohmann::json::parse(R"({"nodes": [
+        {"id": "a", "allowed_parents": []},
+        {"id": "b", "allowed_parents": ["a", "z"]}
+    ]})");
+    EXPECT_THROW(transmission_nets::core::io::parseAllowedParentsFromJSON(input, std::vector({inf1, inf2})), std::invalid_argument);
+    EXPECT_THROW(AllowedRelationships<InfectionEvent>({inf1, inf2}, {{1, 2}}), std::out_of_range);
+}
@@ -7,6 +7,9 @@
 #include "core/containers/Infection.h"
 #include "core/datatypes/Alleles.h"
 
+#include <memory>
+#include <vector>
+
 using namespace transmission_nets::core::datatypes;
 using namespace transmission_nets::core::containers;
 using namespace transmission_nets::core::parameters;
@@ -98,4 +101,58 @@ TEST(InfectionTest, HandlesCopyingInfection) {
     EXPECT_EQ(inf2->latentGenotype(as2)->value().allelesStr(), "00000011");
     fmt::print("HandlesCopyingInfection Complete.\n");
 
-}
\ No newline at end of file
+}
+TEST(InfectionTest, AddressesGenotypesByLocusIndex) {
+    using GeneticsImpl = AllelesBitSet<16>;
+    using Infection    = Infection<GeneticsImpl, Locus>;
+
+    // Loci of a model are indexed densely, an infection may lack genotypes at some of them
+    auto as1 = std::make_shared<Locus>("AS1", 6, 0);
+    auto as2 = std::make_shared<Locus>("AS2", 8, 1);
+    auto as3 = std::make_shared<Locus>("AS3", 4, 2);
+
+    auto inf1 = std::make_shared<Infection>("inf1", 10.0, false);
+    inf1->addGenetics(as3, GeneticsImpl("0110"), GeneticsImpl("0111"));
+    inf1->addLatentGenetics(as1, GeneticsImpl("011010"));
+
+    EXPECT_EQ(inf1->latentGenotypeValue(2).allelesStr(), "0111");
+    EXPECT_EQ(inf1->latentGenotypeValue(as1).allelesStr(), "011010");
+    EXPECT_EQ(&inf1->latentGenotypeValue(as3), &inf1->latentGenotype(as3)->value());
+    EXPECT_EQ(inf1->latentGenotype(as3), inf1->latentGenotype().at(as3));
+    EXPECT_EQ(inf1->observedGenotype(as3)->value().allelesStr(), "0110");
+
+    EXPECT_THROW(inf1->latentGenotype(as2), std::out_of_range);
+    EXPECT_THROW(inf1->observedGenotype(as1), std::out_of_range);
+
+    // A locus of another model that shares an index is not mistaken for the infection's locus
+    auto other = std::make_shared<Locus>("OTHER", 4, 2);
+    EXPECT_THROW(inf1->latentGenotype(other), std::out_of_range);
+    EXPECT_FALSE(inf1->latentGenotype().contains(other));
+
+    // Genotypes are visited in the order they were added
+    std::vector<std::shared_ptr<Locus>> visited;
+    for (const auto& [locus, genotype] : inf1->latentGenotype()) {
+        visited.push_back(locus);
+    }
+    EXPECT_EQ(visited, (std::vector{as3, as1}));
+
+    // Copies address the same loci
+    auto inf2 = std::make_shared<Infection>(*inf1, "inf2");
+    EXPECT_EQ(inf2->latentGenotypeValue(as3).allelesStr(), "0111");
+    EXPECT_NE(inf2->latentGenotype(as3), inf1->latentGenotype(as3));
+}
+
+TEST(InfectionTest, CopiesDrawUniqueUids) {
+    using GeneticsImpl = AllelesBitSet<16>;
+    using Infection    = Infection<GeneticsImpl, Locus>;
+
+    // Latent parents are copies of infections, their uids are packed into parent set keys alongside the infections' uids
+    auto as1          = std::make_shared<Locus>("AS1", 6);
+    auto inf1         = std::make_shared<Infection>("inf1", 10.0, false);
+    inf1->addGenetics(as1, GeneticsImpl("011010"), GeneticsImpl("011010"));
+    auto latentParent = std::make_shared<Infection>(*inf1, "latent_parent_inf1");
+    auto inf2         = std::make_shared<Infection>("inf2", 12.0, false);
+
+    EXPECT_EQ(latentParent->uid(), static_cast<unsigned short>(inf1->uid() + 1));
+    EXPECT_EQ(inf2->uid(), static_cast<unsigned short>(latentParent->uid() + 1));
+}
@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+
+#include "core/containers/JournaledCache.h"
+
+using namespace transmission_nets::core::containers;
+
+TEST(JournaledCacheTest, HandlesRollback) {
+    JournaledCache<int, double> cache;
+    cache.set(1, 1.0);
+    cache.set(2, 2.0);
+
+    cache.checkpoint();
+    cache.set(1, 10.0);
+    cache.set(3, 3.0);
+    cache.update(3, [](double& v) { v *= 2; });
+    cache.erase(2);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_DOUBLE_EQ(cache.at(3), 6.0);
+    EXPECT_DOUBLE_EQ(cache.at(1), 10.0);
+    EXPECT_FALSE(cache.contains(2));
+
+    cache.rollback();
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_DOUBLE_EQ(cache.at(1), 1.0);
+    EXPECT_DOUBLE_EQ(cache.at(2), 2.0);
+    EXPECT_FALSE(cache.contains(3));
+    EXPECT_FALSE(cache.checkpointed());
+}
+
+TEST(JournaledCacheTest, HandlesNestedCheckpointsAndClear) {
+    JournaledCache<int, double> cache;
+    cache.set(1, 1.0);
+    cache.set(2, 2.0);
+
+    cache.checkpoint();
+    cache.eraseIf([](const int key) { return key == 1; });
+    cache.checkpoint();
+    cache.clear();
+    cache.set(4, 4.0);
+    EXPECT_EQ(cache.size(), 1u);
+
+    cache.rollback();
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_DOUBLE_EQ(cache.at(2), 2.0);
+
+    cache.rollback();
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_DOUBLE_EQ(cache.at(1), 1.0);
+}
+
+TEST(JournaledCacheTest, HandlesCommit) {
+    JournaledCache<int, double> cache;
+    cache.set(1, 1.0);
+
+    cache.checkpoint();
+    cache.set(1, 5.0);
+    cache.update(1, [](double& v) { v += 1; });
+    EXPECT_DOUBLE_EQ(cache.at(1), 6.0);
+    cache.clear();
+    cache.set(2, 2.0);
+    cache.commit();
+
+    EXPECT_FALSE(cache.checkpointed());
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_DOUBLE_EQ(cache.at(2), 2.0);
+}
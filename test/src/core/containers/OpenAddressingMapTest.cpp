@@ -0,0 +1,84 @@
+#include "gtest/gtest.h"
+
+#include "core/containers/JournaledCache.h"
+#include "core/containers/OpenAddressingMap.h"
+
+#include <map>
+#include <random>
+
+using namespace transmission_nets::core::containers;
+
+TEST(OpenAddressingMapTest, MatchesReferenceMap) {
+    OpenAddressingMap<int> map;
+    std::map<std::uint64_t, int> reference;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<std::uint64_t> keyDist(1, 300);
+
+    // Enough churn to trigger growth and rehashing over tombstones
+    for (int i = 0; i < 20000; ++i) {
+        const auto key = keyDist(rng);
+        if (rng() % 3 == 0) {
+            EXPECT_EQ(map.erase(key), reference.erase(key));
+        } else {
+            const bool inserted = map.insert_or_assign(key, i).second;
+            EXPECT_EQ(inserted, !reference.contains(key));
+            reference[key] = i;
+        }
+        ASSERT_EQ(map.size(), reference.size());
+    }
+
+    for (const auto& [key, value] : reference) {
+        ASSERT_NE(map.find(key), map.end());
+        EXPECT_EQ(map.at(key), value);
+    }
+
+    std::size_t visited = 0;
+    for (const auto& [key, value] : map) {
+        EXPECT_EQ(reference.at(key), value);
+        visited++;
+    }
+    EXPECT_EQ(visited, reference.size());
+}
+
+TEST(OpenAddressingMapTest, ErasesWhileIterating) {
+    OpenAddressingMap<double> map;
+    for (std::uint64_t key = 1; key <= 100; ++key) {
+        map.insert_or_assign(key, static_cast<double>(key));
+    }
+
+    for (auto it = map.begin(); it != map.end();) {
+        it = it->first % 2 == 0 ? map.erase(it) : std::next(it);
+    }
+    EXPECT_EQ(map.size(), 50u);
+    for (std::uint64_t key = 1; key <= 100; ++key) {
+        EXPECT_EQ(map.find(key) == map.end(), key % 2 == 0);
+    }
+
+    auto moved = std::move(map);
+    EXPECT_EQ(moved.size(), 50u);
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(1), map.end());
+}
+
+TEST(OpenAddressingMapTest, BacksJournaledCache) {
+    JournaledCache<std::uint64_t, double, OpenAddressingMap<double>> cache;
+    cache.set(1, 1.0);
+    cache.set(2, 2.0);
+
+    cache.checkpoint();
+    cache.eraseIf([](const std::uint64_t key) { return key == 1; });
+    cache.set(3, 3.0);
+    cache.checkpoint();
+    cache.clear();
+    cache.set(4, 4.0);
+
+    cache.rollback();
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_DOUBLE_EQ(cache.at(3), 3.0);
+
+    cache.rollback();
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_DOUBLE_EQ(cache.at(1), 1.0);
+    EXPECT_DOUBLE_EQ(cache.at(2), 2.0);
+    EXPECT_FALSE(cache.contains(3));
+}
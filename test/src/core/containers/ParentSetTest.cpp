@@ -0,0 +1,47 @@
+#include "gtest/gtest.h"
+
+#include "core/containers/Infection.h"
+#include "core/containers/ParentSet.h"
+#include "core/datatypes/Alleles.h"
+
+#include <vector>
+
+using namespace transmission_nets::core::datatypes;
+using namespace transmission_nets::core::containers;
+
+namespace {
+    using InfectionEvent = Infection<AllelesBitSet<16>>;
+}// namespace
+
+TEST(BorrowedParentSetTest, IteratesInParentSetOrderWithoutSharingOwnership) {
+    std::vector<std::shared_ptr<InfectionEvent>> infections;
+    for (int i = 0; i < 4; ++i) {
+        infections.push_back(std::make_shared<InfectionEvent>(std::to_string(i), 10.0 * i));
+    }
+
+    std::vector<long> useCounts;
+    for (const auto& inf : infections) {
+        useCounts.push_back(inf.use_count());
+    }
+
+    ParentSet<InfectionEvent> owned{};
+    BorrowedParentSet<InfectionEvent, 4> borrowed{};
+    for (const int idx : {2, 0, 3, 0}) {
+        owned.insert(infections[idx]);
+        borrowed.insert(infections[idx]);
+    }
+
+    ASSERT_EQ(borrowed.size(), owned.size());
+    auto it = borrowed.begin();
+    for (const auto& inf : owned) {
+        EXPECT_EQ(*it++, inf.get());
+    }
+    for (std::size_t i = 0; i < infections.size(); ++i) {
+        EXPECT_EQ(infections[i].use_count(), useCounts[i] + owned.contains(infections[i]));
+    }
+
+    borrowed.clear();
+    EXPECT_TRUE(borrowed.empty());
+    borrowed.insert(infections[1].get());
+    EXPECT_EQ(*borrowed.begin(), infections[1].get());
+}
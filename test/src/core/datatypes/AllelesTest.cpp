@@ -6,6 +6,9 @@
 #include "core/parameters/Parameter.h"
 #include "gtest/gtest.h"
 
+#include <random>
+#include <type_traits>
+
 constexpr int MAX_ALLELES = 24;
 
 
@@ -58,6 +61,21 @@ TEST_F(AllelesTestFixture, HandlesIteration) {
     }
 }
 
+TEST_F(AllelesTestFixture, HandlesSetAlleleIteration) {
+    // "10010"
+    std::vector<std::size_t> present{};
+    a3.forEachAllele([&present](std::size_t pos) { present.push_back(pos); });
+    ASSERT_EQ(present, (std::vector<std::size_t>{0, 3}));
+
+    // Spans more than one 64 bit word
+    std::string bitstr(100, '0');
+    bitstr[0] = bitstr[63] = bitstr[64] = bitstr[99] = '1';
+    AllelesBitSet<128> wide(bitstr);
+    present.clear();
+    wide.forEachAllele([&present](std::size_t pos) { present.push_back(pos); });
+    ASSERT_EQ(present, (std::vector<std::size_t>{0, 63, 64, 99}));
+}
+
 TEST_F(AllelesTestFixture, ParameterTest) {
     Parameter<GeneticsImpl> p(a1);
     p.saveState(1);
@@ -106,6 +124,49 @@ TEST(AllelesTest, HandlesMutationMask) {
     ASSERT_EQ(a1.mutationMask(a4), GeneticsImpl("0010"));
     ASSERT_EQ(a1.mutationMask(a2).mutationMask(a3).mutationMask(a4), GeneticsImpl("0000"));
     ASSERT_EQ(a1.mutationMask(a2).mutationMask(a3), a1.mutationMask(a3).mutationMask(a2));
+}
 
-
+TEST(AllelesTest, SingleWordMatchesMultiWord) {
+    // Widths up to 64 alleles use the single word specialization
+    static_assert(std::is_trivially_copyable_v<AllelesBitSet<64>>);
+    static_assert(sizeof(AllelesBitSet<64>) < sizeof(AllelesBitSet<128>));
+    static_assert(allelesBitSetWidth(20) == 64 and allelesBitSetWidth(64) == 64 and allelesBitSetWidth(65) == 128);
+
+    std::mt19937 rng(7);
+    std::bernoulli_distribution present(.3);
+    const auto randomBitstr = [&](const std::size_t totalAlleles) {
+        std::string bitstr(totalAlleles, '0');
+        for (auto& c : bitstr) {
+            c = present(rng) ? '1' : '0';
+        }
+        return bitstr;
+    };
+
+    for (const std::size_t totalAlleles : {1, 5, 20, 63, 64}) {
+        for (int i = 0; i < 20; ++i) {
+            const auto parentStr = randomBitstr(totalAlleles);
+            const auto childStr  = randomBitstr(totalAlleles);
+            const AllelesBitSet<64> parent(parentStr), child(childStr);
+            const AllelesBitSet<128> wideParent(parentStr), wideChild(childStr);
+
+            ASSERT_EQ(child.allelesStr(), childStr);
+            ASSERT_EQ(child.totalPositiveCount(), wideChild.totalPositiveCount());
+            ASSERT_EQ(child.totalNegativeCount(), wideChild.totalNegativeCount());
+            ASSERT_EQ(AllelesBitSet<64>::truePositiveCount(parent, child), AllelesBitSet<128>::truePositiveCount(wideParent, wideChild));
+            ASSERT_EQ(AllelesBitSet<64>::falsePositiveCount(parent, child), AllelesBitSet<128>::falsePositiveCount(wideParent, wideChild));
+            ASSERT_EQ(AllelesBitSet<64>::falseNegativeCount(parent, child), AllelesBitSet<128>::falseNegativeCount(wideParent, wideChild));
+            ASSERT_EQ(AllelesBitSet<64>::trueNegativeCount(parent, child), AllelesBitSet<128>::trueNegativeCount(wideParent, wideChild));
+            ASSERT_EQ(AllelesBitSet<64>::covers(parent, child), AllelesBitSet<128>::covers(wideParent, wideChild));
+            ASSERT_EQ(AllelesBitSet<64>::shared(parent, child).allelesStr(), AllelesBitSet<128>::shared(wideParent, wideChild).allelesStr());
+            ASSERT_EQ(AllelesBitSet<64>::any(parent, child).allelesStr(), AllelesBitSet<128>::any(wideParent, wideChild).allelesStr());
+            ASSERT_EQ(AllelesBitSet<64>::diff(parent, child).allelesStr(), AllelesBitSet<128>::diff(wideParent, wideChild).allelesStr());
+            ASSERT_EQ(AllelesBitSet<64>::invert(child).allelesStr(), AllelesBitSet<128>::invert(wideChild).allelesStr());
+            ASSERT_EQ(child.mutationMask(parent).allelesStr(), wideChild.mutationMask(wideParent).allelesStr());
+
+            std::vector<std::size_t> positions, widePositions;
+            child.forEachAllele([&](std::size_t pos) { positions.push_back(pos); });
+            wideChild.forEachAllele([&](std::size_t pos) { widePositions.push_back(pos); });
+            ASSERT_EQ(positions, widePositions);
+        }
+    }
 }
@@ -49,3 +49,17 @@ TEST(SimplexTest, ParameterTest) {
     p2.restoreState(1);
     ASSERT_DOUBLE_EQ(p2.value().frequencies(0), 1.0 / 3.0);
 }
+
+TEST(SimplexTest, LargeLocusTest) {
+    // Amplicon loci may have more alleles than fit in the inline storage
+    Simplex av(300);
+    ASSERT_EQ(av.totalElements(), 300);
+    ASSERT_DOUBLE_EQ(av.frequencies(299), 1.0 / 300.0);
+
+    av.set(299, .4);
+    ASSERT_DOUBLE_EQ(av.frequencies(299), .4);
+    ASSERT_DOUBLE_EQ(av.frequencies(0), .6 / 299.0);
+
+    const Simplex copy = av;
+    ASSERT_EQ(copy.frequencies(), av.frequencies());
+}
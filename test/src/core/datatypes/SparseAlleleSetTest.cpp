@@ -0,0 +1,79 @@
+#include "core/datatypes/Alleles.h"
+#include "core/datatypes/SparseAlleleSet.h"
+#include "gtest/gtest.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+
+using namespace transmission_nets::core::datatypes;
+
+
+TEST(SparseAlleleSetTest, MatchesAllelesBitSet) {
+    std::mt19937 rng(11);
+    std::bernoulli_distribution present(.3);
+    const auto randomBitstr = [&](const std::size_t totalAlleles) {
+        std::string bitstr(totalAlleles, '0');
+        for (auto& c : bitstr) {
+            c = present(rng) ? '1' : '0';
+        }
+        return bitstr;
+    };
+
+    for (const std::size_t totalAlleles : {1, 5, 20, 64, 100, 128}) {
+        for (int i = 0; i < 20; ++i) {
+            const auto parentStr = randomBitstr(totalAlleles);
+            const auto childStr  = randomBitstr(totalAlleles);
+            const SparseAlleleSet parent(parentStr), child(childStr);
+            const AllelesBitSet<128> denseParent(parentStr), denseChild(childStr);
+
+            ASSERT_EQ(child.allelesStr(), childStr);
+            ASSERT_EQ(child.totalAlleles(), denseChild.totalAlleles());
+            ASSERT_EQ(child.totalPositiveCount(), denseChild.totalPositiveCount());
+            ASSERT_EQ(child.totalNegativeCount(), denseChild.totalNegativeCount());
+            ASSERT_EQ(SparseAlleleSet::truePositiveCount(parent, child), AllelesBitSet<128>::truePositiveCount(denseParent, denseChild));
+            ASSERT_EQ(SparseAlleleSet::falsePositiveCount(parent, child), AllelesBitSet<128>::falsePositiveCount(denseParent, denseChild));
+            ASSERT_EQ(SparseAlleleSet::falseNegativeCount(parent, child), AllelesBitSet<128>::falseNegativeCount(denseParent, denseChild));
+            ASSERT_EQ(SparseAlleleSet::trueNegativeCount(parent, child), AllelesBitSet<128>::trueNegativeCount(denseParent, denseChild));
+            ASSERT_EQ(SparseAlleleSet::covers(parent, child), AllelesBitSet<128>::covers(denseParent, denseChild));
+            ASSERT_EQ(SparseAlleleSet::shared(parent, child).allelesStr(), AllelesBitSet<128>::shared(denseParent, denseChild).allelesStr());
+            ASSERT_EQ(SparseAlleleSet::any(parent, child).allelesStr(), AllelesBitSet<128>::any(denseParent, denseChild).allelesStr());
+            ASSERT_EQ(SparseAlleleSet::diff(parent, child).allelesStr(), AllelesBitSet<128>::diff(denseParent, denseChild).allelesStr());
+            ASSERT_EQ(SparseAlleleSet::invert(child).allelesStr(), AllelesBitSet<128>::invert(denseChild).allelesStr());
+            ASSERT_EQ(child.mutationMask(parent).allelesStr(), denseChild.mutationMask(denseParent).allelesStr());
+
+            std::vector<std::size_t> positions, densePositions;
+            child.forEachAllele([&](std::size_t pos) { positions.push_back(pos); });
+            denseChild.forEachAllele([&](std::size_t pos) { densePositions.push_back(pos); });
+            ASSERT_EQ(positions, densePositions);
+        }
+    }
+}
+
+TEST(SparseAlleleSetTest, SetAndFlipKeepAllelesSorted) {
+    // Amplicon loci can carry far more alleles than the bitset widths
+    SparseAlleleSet alleles(std::string(500, '0'));
+    alleles.set(420);
+    alleles.set(3);
+    alleles.flip(250);
+    alleles.set(3);
+
+    std::vector<std::size_t> positions;
+    alleles.forEachAllele([&](std::size_t pos) { positions.push_back(pos); });
+    ASSERT_EQ(positions, (std::vector<std::size_t>{3, 250, 420}));
+    ASSERT_TRUE(alleles.allele(250));
+    ASSERT_FALSE(alleles.allele(251));
+    ASSERT_EQ(alleles.totalPositiveCount(), 3);
+    ASSERT_EQ(alleles.totalNegativeCount(), 497);
+
+    alleles.flip(250);
+    alleles.reset(3);
+    ASSERT_EQ(alleles.totalPositiveCount(), 1);
+    ASSERT_EQ(alleles, SparseAlleleSet(std::string(420, '0') + "1" + std::string(79, '0')));
+
+    alleles.set();
+    ASSERT_EQ(alleles.totalPositiveCount(), 500);
+    alleles.reset();
+    ASSERT_EQ(alleles.totalPositiveCount(), 0);
+}
@@ -62,10 +62,13 @@ TEST(OrderingTest, HandlesSwapsNotifies) {
     fmt::print("{}\n", serialize(p_el2));
     fmt::print("{}\n", serialize(p_el3));
     fmt::print("{}\n", serialize(p_el4));
+    ASSERT_EQ(ordering->value(), (std::vector{el3, el2, el1, el4}));
 
     ordering->restoreState(1);
     fmt::print("{}\n", serialize(p_el1));
     fmt::print("{}\n", serialize(p_el2));
     fmt::print("{}\n", serialize(p_el3));
     fmt::print("{}\n", serialize(p_el4));
+    ASSERT_EQ(ordering->value(), (std::vector{el1, el2, el3, el4}));
+    ASSERT_EQ(p_el3.view().size(), 2);
 }
\ No newline at end of file
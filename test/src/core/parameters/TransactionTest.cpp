@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+
+#include "core/abstract/observables/Cacheable.h"
+#include "core/abstract/observables/Observable.h"
+#include "core/parameters/Parameter.h"
+#include "core/parameters/Transaction.h"
+
+#include <string>
+#include <vector>
+
+using namespace transmission_nets::core::parameters;
+
+TEST(TransactionTest, CoalescesNotifications) {
+    Parameter<double> duration(10.0);
+    Parameter<std::string> genotype(std::string("0101"));
+    Parameter<std::string> unchanged(std::string("1100"));
+
+    std::vector<std::string> events{};
+    duration.add_pre_change_listener([&]() { events.emplace_back("pre duration"); });
+    duration.add_post_change_listener([&]() { events.emplace_back("post duration"); });
+    genotype.add_pre_change_listener([&]() { events.emplace_back("pre genotype"); });
+    genotype.add_post_change_listener([&]() { events.emplace_back("post genotype " + genotype.value()); });
+    unchanged.add_post_change_listener([&]() { events.emplace_back("post unchanged"); });
+
+    Transaction transaction(1);
+    transaction.set(duration, 12.0);
+    transaction.set(genotype, std::string("0111"));
+    transaction.set(genotype, std::string("0011"));
+    transaction.set(unchanged, std::string("1100"));
+
+    // Values change immediately, listeners only hear about them on commit
+    EXPECT_EQ(genotype.value(), "0011");
+    EXPECT_EQ(events, (std::vector<std::string>{"pre duration", "pre genotype"}));
+    EXPECT_EQ(transaction.size(), 2);
+    EXPECT_FALSE(unchanged.isSaved());
+
+    transaction.commit();
+    EXPECT_EQ(events, (std::vector<std::string>{"pre duration", "pre genotype", "post duration", "post genotype 0011"}));
+    transaction.accept();
+}
+
+namespace {
+    class Dependent : public transmission_nets::core::abstract::Observable<Dependent>,
+                      public transmission_nets::core::abstract::Cacheable<Dependent> {};
+}// namespace
+
+TEST(TransactionTest, InvalidatesSharedDependentOnce) {
+    Parameter<double> duration(10.0);
+    Parameter<double> rate(0.5);
+
+    // A dependent of both parameters, and a dependent of it
+    Dependent shared;
+    Dependent downstream;
+    int downstreamInvalidations = 0;
+    duration.add_post_change_listener([&]() { shared.setDirty(); });
+    rate.add_post_change_listener([&]() { shared.setDirty(); });
+    shared.add_set_dirty_listener([&]() { downstream.setDirty(); });
+    downstream.add_set_dirty_listener([&]() { ++downstreamInvalidations; });
+
+    Transaction transaction(1);
+    transaction.set(duration, 12.0);
+    transaction.set(rate, 0.25);
+    transaction.commit();
+    EXPECT_EQ(downstreamInvalidations, 1);
+    EXPECT_TRUE(shared.isDirty());
+    transaction.restore();
+
+    // Outside a transaction every change is passed on
+    duration.saveState(1);
+    duration.setValue(12.0);
+    duration.setValue(14.0);
+    duration.restoreState(1);
+    EXPECT_EQ(downstreamInvalidations, 3);
+}
+
+TEST(TransactionTest, RestoresAndAcceptsAsUnit) {
+    Parameter<double> duration(10.0);
+    Parameter<std::string> genotype(std::string("0101"));
+
+    Transaction rejected(1);
+    rejected.set(duration, 12.0);
+    rejected.set(genotype, std::string("0011"));
+    rejected.commit();
+    rejected.restore();
+    EXPECT_DOUBLE_EQ(duration.value(), 10.0);
+    EXPECT_EQ(genotype.value(), "0101");
+    EXPECT_FALSE(duration.isSaved());
+    EXPECT_FALSE(genotype.isSaved());
+
+    Transaction accepted(1);
+    accepted.set(duration, 12.0);
+    accepted.set(genotype, std::string("0011"));
+    accepted.commit();
+    accepted.accept();
+    EXPECT_DOUBLE_EQ(duration.value(), 12.0);
+    EXPECT_EQ(genotype.value(), "0011");
+    EXPECT_FALSE(duration.isSaved());
+    EXPECT_FALSE(genotype.isSaved());
+}
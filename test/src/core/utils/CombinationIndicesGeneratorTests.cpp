@@ -3,11 +3,14 @@
 //
 
 #include "core/utils/generators/CombinationIndicesGenerator.h"
+#include "core/utils/generators/FixedCombinationIndicesGenerator.h"
 #include "gtest/gtest.h"
 
 
 #include <fmt/core.h>
 
+#include <algorithm>
+
 using namespace transmission_nets::core::utils;
 
 TEST(CombinationsIndicesGeneratorTest, HandlesGeneratingCombos) {
@@ -51,4 +54,56 @@ TEST(CombinationsIndicesGeneratorTest, HandlesNoChoices) {
     generators::CombinationIndicesGenerator cs(0, 10);
     ASSERT_EQ(cs.curr.size(), 10);
     ASSERT_TRUE(cs.completed);
-}
\ No newline at end of file
+}
+
+TEST(CombinationsIndicesGeneratorTest, AdvanceMatchesRepeatedNext) {
+    for (const std::size_t n : {1, 2, 5, 9}) {
+        for (std::size_t r = 1; r <= 3 and r <= n; ++r) {
+            const auto total = generators::binomialCoefficient(n, r);
+            for (unsigned long steps = 0; steps <= total; ++steps) {
+                generators::CombinationIndicesGenerator stepped(n, r);
+                for (unsigned long i = 0; i < steps and !stepped.completed; ++i) {
+                    stepped.next();
+                }
+
+                generators::CombinationIndicesGenerator jumped(n, r);
+                jumped.advance(static_cast<int>(steps));
+                generators::FixedCombinationIndicesGenerator<3> fixed(n, r);
+                fixed.advance(steps);
+
+                ASSERT_EQ(jumped.curr, stepped.curr);
+                ASSERT_EQ(jumped.completed, stepped.completed);
+                ASSERT_EQ(jumped.generated, stepped.generated);
+                ASSERT_TRUE(std::ranges::equal(fixed.curr(), stepped.curr));
+                ASSERT_EQ(fixed.completed, stepped.completed);
+                ASSERT_EQ(fixed.generated, stepped.generated);
+            }
+        }
+    }
+}
+
+TEST(CombinationsIndicesGeneratorTest, FixedMatchesDynamic) {
+    generators::FixedCombinationIndicesGenerator<2> fixed;
+    generators::CombinationIndicesGenerator dynamic;
+    for (std::size_t r = 1; r <= 2; ++r) {
+        fixed.reset(10, r);
+        dynamic.reset(10, r);
+        ASSERT_EQ(fixed.numCombinations, dynamic.numCombinations);
+        while (!dynamic.completed) {
+            ASSERT_FALSE(fixed.completed);
+            ASSERT_TRUE(std::ranges::equal(fixed.curr(), dynamic.curr));
+            fixed.next();
+            dynamic.next();
+        }
+        ASSERT_TRUE(fixed.completed);
+        ASSERT_EQ(fixed.generated, dynamic.generated);
+    }
+
+    // The generator does not allocate, so unranking can be checked at compile time
+    static_assert([] {
+        generators::FixedCombinationIndicesGenerator<2> gen(5, 2);
+        gen.advance(6);
+        return gen.curr()[0] == 1 and gen.curr()[1] == 4;
+    }());
+    static_assert(generators::binomialCoefficient(60, 30) == 118264581564861424ull);
+}
@@ -6,6 +6,8 @@
 
 #include "core/utils/ProbAnyMissing.h"
 
+#include <array>
+
 using namespace transmission_nets::core::utils;
 
 TEST(ProbAnyMissingTests, TestSimpleVec) {
@@ -15,3 +17,111 @@ TEST(ProbAnyMissingTests, TestSimpleVec) {
     ASSERT_NEAR(probAnyMissing({.1, .2, .3, .4}, 5), 0.856, 1e-3);
     ASSERT_NEAR(probAnyMissing({.1, .2, .7}, 4), .832, 1e-3);
 }
+
+TEST(ProbAnyMissingTests, TestVectorizedIntoBuffer) {
+
+    probAnyMissingFunctor probAnyMissing;
+    const std::vector<Likelihood> eventProbs{.1, .2, .3, .4};
+    const auto expected = probAnyMissing.vectorized(eventProbs, 8);
+
+    std::array<Likelihood, 8> out{};
+    probAnyMissing.vectorized(eventProbs.data(), eventProbs.size(), 8, out.data());
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        ASSERT_DOUBLE_EQ(out[i], expected[i]);
+        if (i + 1 >= eventProbs.size()) {
+            ASSERT_NEAR(out[i], probAnyMissing(eventProbs, i + 1), 1e-12);
+        } else {
+            ASSERT_EQ(out[i], 1.0);
+        }
+    }
+
+    probAnyMissing.vectorized(eventProbs.data(), eventProbs.size(), 3, out.data());
+    ASSERT_EQ(out[0], 1.0);
+    ASSERT_EQ(out[2], 1.0);
+}
+
+TEST(ProbAnyMissingTests, TestKernelsAgree) {
+
+    probAnyMissingFunctor probAnyMissing;
+    ASSERT_TRUE(probAnyMissingFunctor::supported(probAnyMissingFunctor::Kernel::Scalar));
+    ASSERT_TRUE(probAnyMissingFunctor::supported(probAnyMissingFunctor::bestKernel()));
+
+    // Cover subset counts below, at and above the width of each vector unit
+    const std::vector<std::vector<Likelihood>> eventProbSets{
+            {.5, .5},
+            {.1, .2, .7},
+            {.1, .2, .3, .4},
+            {.05, .1, .15, .2, .5},
+            {.02, .08, .1, .1, .2, .2, .3}};
+
+    constexpr unsigned int numEvents = 20;
+    for (const auto& eventProbs : eventProbSets) {
+        std::array<Likelihood, numEvents> scalar{};
+        probAnyMissing.vectorized(eventProbs.data(), eventProbs.size(), numEvents, scalar.data(), probAnyMissingFunctor::Kernel::Scalar);
+        for (std::size_t i = eventProbs.size() - 1; i < numEvents; ++i) {
+            ASSERT_NEAR(scalar[i], probAnyMissing(eventProbs, i + 1), 1e-12);
+        }
+
+        for (const auto kernel : {probAnyMissingFunctor::Kernel::AVX2, probAnyMissingFunctor::Kernel::AVX512}) {
+            if (!probAnyMissingFunctor::supported(kernel)) {
+                continue;
+            }
+            std::array<Likelihood, numEvents> out{};
+            probAnyMissing.vectorized(eventProbs.data(), eventProbs.size(), numEvents, out.data(), kernel);
+            // Every kernel sums in the same order
+            for (std::size_t i = 0; i < numEvents; ++i) {
+                ASSERT_EQ(out[i], scalar[i]);
+            }
+        }
+    }
+}
+
+TEST(ProbAnyMissingTests, TestSubsetBasesDoNotDrift) {
+
+    probAnyMissingFunctor probAnyMissing;
+    std::vector<Likelihood> eventProbs{};
+    for (std::size_t e = 0; e < 16; ++e) {
+        eventProbs.push_back(1.0 / (3.0 + 7.0 * static_cast<Likelihood>(e)));
+    }
+
+    std::array<Likelihood, 16> out{};
+    probAnyMissing.vectorized(eventProbs.data(), eventProbs.size(), out.size(), out.data(), probAnyMissingFunctor::Kernel::Scalar);
+    ASSERT_EQ(probAnyMissing.baseVec.size(), (std::size_t{1} << eventProbs.size()) - 1);
+
+    // Each base matches the subset sum taken directly, however many subsets were enumerated before it
+    for (std::size_t mask = 1; mask < (std::size_t{1} << eventProbs.size()); ++mask) {
+        Likelihood subsetProb = 0.0;
+        for (std::size_t e = eventProbs.size(); e-- > 0;) {
+            if ((mask >> e) & 1) {
+                subsetProb += eventProbs[e];
+            }
+        }
+        ASSERT_EQ(probAnyMissing.baseVec[mask - 1], 1.0 - subsetProb);
+    }
+}
+
+TEST(ProbAnyMissingTests, TestUnrolledSmallEventSets) {
+
+    probAnyMissingFunctor probAnyMissing;
+    const std::vector<Likelihood> eventProbs{.15, .25, .35, .25};
+
+    constexpr unsigned int numEvents = 12;
+    for (std::size_t totalEvents = 1; totalEvents <= probAnyMissingFunctor::maxUnrolledEvents; ++totalEvents) {
+        std::array<Likelihood, numEvents> general{};
+        std::array<Likelihood, numEvents> unrolled{};
+        probAnyMissing.vectorized(eventProbs.data(), totalEvents, numEvents, general.data(), probAnyMissingFunctor::Kernel::Scalar);
+        probAnyMissing.vectorized(eventProbs.data(), totalEvents, numEvents, unrolled.data());
+        for (std::size_t i = 0; i < numEvents; ++i) {
+            ASSERT_NEAR(unrolled[i], general[i], 1e-12);
+        }
+
+        // Fewer trials than events
+        probAnyMissing.vectorized(eventProbs.data(), totalEvents, totalEvents - 1, unrolled.data());
+        for (std::size_t i = 0; i + 1 < totalEvents; ++i) {
+            ASSERT_EQ(unrolled[i], 1.0);
+        }
+    }
+
+    ASSERT_NEAR(probAnyMissing.vectorized({1.0}, 3)[2], 0.0, 1e-12);
+    ASSERT_NEAR(probAnyMissing.vectorized({.5, .5}, 2)[1], .5, 1e-12);
+}
@@ -0,0 +1,219 @@
+#include "gtest/gtest.h"
+
+#include "core/datatypes/Alleles.h"
+#include "core/datatypes/Simplex.h"
+
+#include "core/computation/ObservationTimeDerivedOrdering.h"
+#include "core/computation/OrderDerivedParentSet.h"
+
+#include "core/containers/AlleleFrequencyContainer.h"
+#include "core/containers/Infection.h"
+#include "core/containers/Locus.h"
+
+#include "core/distributions/ZTGeometric.h"
+#include "core/distributions/ZTPoisson.h"
+
+#include "model/transmission_process/OrderBasedTransmissionProcessV3.h"
+#include "model/transmission_process/node_transmission_process/MultinomialTransmissionProcess.h"
+#include "model/transmission_process/source_transmission_process/MultinomialSourceTransmissionProcess.h"
+
+using namespace transmission_nets::core::parameters;
+using namespace transmission_nets::core::containers;
+using namespace transmission_nets::core::computation;
+using namespace transmission_nets::core::datatypes;
+using namespace transmission_nets::core::distributions;
+using namespace transmission_nets::model::transmission_process;
+
+namespace {
+    constexpr int MAX_PARENTS = 2;
+    constexpr int MAX_ALLELES = 32;
+    constexpr int MAX_COI     = 10;
+    constexpr int MAX_STRAINS = 12;
+
+    using GeneticsImpl                 = AllelesBitSet<MAX_ALLELES>;
+    using InfectionEvent               = Infection<GeneticsImpl>;
+    using AlleleFrequencyContainerImpl = AlleleFrequencyContainer<Simplex>;
+    using OrderingImpl                 = ObservationTimeDerivedOrdering<InfectionEvent>;
+    using ParentSetImpl                = OrderDerivedParentSet<InfectionEvent, OrderingImpl>;
+
+    using COIProbabilityImpl          = ZTPoisson<MAX_COI>;
+    using ParentSetSizeLikelihoodImpl = ZTGeometric<MAX_PARENTS + 1>;
+    using SourceTransmissionImpl      = MultinomialSourceTransmissionProcess<COIProbabilityImpl, AlleleFrequencyContainerImpl, InfectionEvent::GenotypeParameterMap, MAX_COI>;
+    using NodeTransmissionImpl        = MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionImpl, ParentSetSizeLikelihoodImpl>;
+    using TransmissionProcess         = OrderBasedTransmissionProcessV3<MAX_PARENTS, NodeTransmissionImpl, SourceTransmissionImpl, ParentSetSizeLikelihoodImpl, InfectionEvent, ParentSetImpl>;
+}// namespace
+
+class OrderBasedTransmissionProcessV3TestFixture : public ::testing::Test {
+protected:
+    OrderBasedTransmissionProcessV3TestFixture() {
+        as1 = std::make_shared<Locus>("AS1", 5);
+        as2 = std::make_shared<Locus>("AS2", 6);
+
+        inf1 = std::make_shared<InfectionEvent>("1", 100, false);
+        inf2 = std::make_shared<InfectionEvent>("2", 110, false);
+        inf3 = std::make_shared<InfectionEvent>("3", 120, false);
+
+        inf1->addGenetics(as1, "11010", "11010");
+        inf1->addGenetics(as2, "000011", "000011");
+        inf2->addGenetics(as1, "01010", "01010");
+        inf2->addGenetics(as2, "100010", "100010");
+        inf3->addGenetics(as1, "11000", "11000");
+        inf3->addGenetics(as2, "100011", "100011");
+
+        latentParent = std::make_shared<InfectionEvent>(*inf3);
+
+        auto ordering = std::make_shared<OrderingImpl>(std::vector{inf1, inf2, inf3});
+        parentSet     = std::make_shared<ParentSetImpl>(ordering, inf3, std::vector{inf1, inf2});
+
+        auto afc = std::make_shared<AlleleFrequencyContainerImpl>();
+        afc->addLocus(as1);
+        afc->addLocus(as2);
+
+        coiMean     = std::make_shared<Parameter<double>>(2.0);
+        psProb      = std::make_shared<Parameter<double>>(.8);
+        meanStrains = std::make_shared<Parameter<double>>(1.5);
+
+        psp = std::make_shared<ParentSetSizeLikelihoodImpl>(psProb);
+        ntp = std::make_shared<NodeTransmissionImpl>(meanStrains);
+        stp = std::make_shared<SourceTransmissionImpl>(std::make_shared<COIProbabilityImpl>(coiMean), afc, latentParent->loci(), latentParent->latentGenotype());
+    }
+
+    // Processes register listeners on the shared components, so every process built is kept alive for the test
+    std::shared_ptr<TransmissionProcess> makeProcess() {
+        return processes.emplace_back(std::make_shared<TransmissionProcess>(ntp, stp, psp, inf3, parentSet, latentParent));
+    }
+
+    std::shared_ptr<Locus> as1, as2;
+    std::shared_ptr<InfectionEvent> inf1, inf2, inf3, latentParent;
+    std::shared_ptr<ParentSetImpl> parentSet;
+    std::shared_ptr<Parameter<double>> coiMean, psProb, meanStrains;
+    std::shared_ptr<ParentSetSizeLikelihoodImpl> psp;
+    std::shared_ptr<NodeTransmissionImpl> ntp;
+    std::shared_ptr<SourceTransmissionImpl> stp;
+    std::vector<std::shared_ptr<TransmissionProcess>> processes;
+};
+
+TEST_F(OrderBasedTransmissionProcessV3TestFixture, RecombinesOnNumParentTermUpdates) {
+    auto tp = makeProcess();
+    const Likelihood initial = tp->value();
+    ASSERT_TRUE(std::isfinite(initial));
+
+    meanStrains->saveState(1);
+    meanStrains->setValue(2.5);
+    EXPECT_TRUE(tp->isDirty());
+    EXPECT_DOUBLE_EQ(tp->value(), makeProcess()->value());
+    EXPECT_NE(tp->value(), initial);
+
+    meanStrains->restoreState(1);
+    EXPECT_FALSE(tp->isDirty());
+    EXPECT_DOUBLE_EQ(tp->value(), initial);
+
+    psProb->saveState(2);
+    psProb->setValue(.3);
+    EXPECT_TRUE(tp->isDirty());
+    EXPECT_DOUBLE_EQ(tp->value(), makeProcess()->value());
+    psProb->acceptState();
+
+    coiMean->saveState(3);
+    coiMean->setValue(4.0);
+    EXPECT_TRUE(tp->isDirty());
+    EXPECT_DOUBLE_EQ(tp->value(), makeProcess()->value());
+    coiMean->acceptState();
+}
+
+TEST_F(OrderBasedTransmissionProcessV3TestFixture, RestoresCombinedLikelihoods) {
+    auto tp = makeProcess();
+    const Likelihood initial = tp->value();
+
+    // Recombine within a proposal that is rejected, then make sure nothing stale survives the restore
+    meanStrains->saveState(1);
+    meanStrains->setValue(3.0);
+    tp->value();
+    meanStrains->restoreState(1);
+    EXPECT_DOUBLE_EQ(tp->value(), initial);
+
+    auto genotype = inf1->latentGenotype(as1);
+    genotype->saveState(2);
+    genotype->setValue(GeneticsImpl("01000"));
+    EXPECT_TRUE(tp->isDirty());
+    EXPECT_DOUBLE_EQ(tp->value(), makeProcess()->value());
+    genotype->restoreState(2);
+    EXPECT_DOUBLE_EQ(tp->value(), initial);
+
+    meanStrains->saveState(3);
+    meanStrains->setValue(3.0);
+    EXPECT_DOUBLE_EQ(tp->value(), makeProcess()->value());
+    meanStrains->acceptState();
+}
+
+TEST_F(OrderBasedTransmissionProcessV3TestFixture, UpdatesSingleLocusChanges) {
+    auto tp = makeProcess();
+    const Likelihood initial = tp->value();
+
+    // Each of the child, a parent and the latent parent changes at a single locus
+    const std::vector<std::pair<std::shared_ptr<Parameter<GeneticsImpl>>, GeneticsImpl>> proposals{
+            {inf3->latentGenotype(as2), GeneticsImpl("100010")},
+            {inf2->latentGenotype(as1), GeneticsImpl("11000")},
+            {latentParent->latentGenotype(as2), GeneticsImpl("100001")},
+            {inf1->latentGenotype(as2), GeneticsImpl("100011")}};
+
+    int stateId = 1;
+    for (const auto& [genotype, proposal] : proposals) {
+        genotype->saveState(stateId);
+        genotype->setValue(proposal);
+        EXPECT_TRUE(tp->isDirty());
+        EXPECT_DOUBLE_EQ(tp->value(), makeProcess()->value());
+        genotype->restoreState(stateId);
+        EXPECT_DOUBLE_EQ(tp->value(), initial);
+        stateId++;
+    }
+
+    // Accepted changes accumulate
+    for (const auto& [genotype, proposal] : proposals) {
+        genotype->saveState(stateId);
+        genotype->setValue(proposal);
+        EXPECT_DOUBLE_EQ(tp->value(), makeProcess()->value());
+        genotype->acceptState();
+        stateId++;
+    }
+}
+
+TEST_F(OrderBasedTransmissionProcessV3TestFixture, SkipsParentSetsNotCoveringChild) {
+    // Neither parent alone carries all alleles of the child at AS2, together they do
+    auto tp = makeProcess();
+    const Likelihood initial = tp->value();
+    EXPECT_EQ(tp->skippedEvaluations(), 2);
+
+    auto dist = tp->calcParentSetDist();
+    EXPECT_DOUBLE_EQ(dist.totalLlik, initial);
+    for (const auto& [llik, ps] : dist.parentSetLliks) {
+        if (ps.size() == 1 and ps.find(latentParent) == ps.end()) {
+            EXPECT_EQ(llik, -std::numeric_limits<Likelihood>::infinity());
+        } else {
+            EXPECT_TRUE(std::isfinite(llik));
+        }
+    }
+
+    // Make {inf1} feasible, then infeasible again after another locus has changed
+    auto genotype = inf1->latentGenotype(as2);
+    genotype->saveState(1);
+    genotype->setValue(GeneticsImpl("100011"));
+    EXPECT_DOUBLE_EQ(tp->value(), makeProcess()->value());
+    genotype->acceptState();
+
+    genotype->saveState(2);
+    genotype->setValue(GeneticsImpl("000011"));
+    tp->value();
+    genotype->acceptState();
+
+    inf3->latentGenotype(as1)->saveState(3);
+    inf3->latentGenotype(as1)->setValue(GeneticsImpl("11010"));
+    tp->value();
+    inf3->latentGenotype(as1)->acceptState();
+
+    genotype->saveState(4);
+    genotype->setValue(GeneticsImpl("100011"));
+    EXPECT_DOUBLE_EQ(tp->value(), makeProcess()->value());
+    genotype->restoreState(4);
+    EXPECT_DOUBLE_EQ(tp->value(), makeProcess()->value());
+}
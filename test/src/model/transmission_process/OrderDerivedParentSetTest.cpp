@@ -2,12 +2,18 @@
 // Created by Maxwell Murphy on 3/6/20.
 //
 
+#include "core/computation/ObservationTimeDerivedOrdering.h"
 #include "core/computation/OrderDerivedParentSet.h"
+#include "core/containers/Infection.h"
+#include "core/containers/Locus.h"
+#include "core/datatypes/Alleles.h"
 #include "core/parameters/Ordering.h"
 #include "gtest/gtest.h"
 
 using namespace transmission_nets::core::parameters;
 using namespace transmission_nets::core::computation;
+using namespace transmission_nets::core::containers;
+using namespace transmission_nets::core::datatypes;
 
 TEST(OrderDerivedParentSetTest, HandlesReorder) {
 //    auto el1 = std::make_shared<int>(1);
@@ -37,4 +43,53 @@ TEST(OrderDerivedParentSetTest, HandlesReorder) {
     ASSERT_EQ(ops->value().size(), 2);
     ordering->restoreState(1);
     ASSERT_EQ(ops->value().size(), 1);
-}
\ No newline at end of file
+}
+
+TEST(OrderDerivedParentSetTest, RoutesElementChangesToAllowedChildren) {
+    using InfectionEvent = Infection<AllelesBitSet<32>>;
+    using OrderingImpl   = ObservationTimeDerivedOrdering<InfectionEvent>;
+    using ParentSetImpl  = OrderDerivedParentSet<InfectionEvent, OrderingImpl>;
+
+    auto locus = std::make_shared<Locus>("L1", 4);
+    auto inf1  = std::make_shared<InfectionEvent>("1", 100);
+    auto inf2  = std::make_shared<InfectionEvent>("2", 110);
+    auto inf3  = std::make_shared<InfectionEvent>("3", 120);
+    for (const auto& inf : {inf1, inf2, inf3}) {
+        inf->addGenetics(locus, "1100", "1100");
+    }
+
+    auto ordering = std::make_shared<OrderingImpl>(std::vector{inf1, inf2, inf3});
+    auto ps2      = std::make_shared<ParentSetImpl>(ordering, inf2, std::vector{inf1});
+    auto ps3      = std::make_shared<ParentSetImpl>(ordering, inf3, std::vector{inf2});
+
+    const auto setGenotype = [&](const auto& inf, const char* alleles) {
+        auto genotype = inf->latentGenotype(locus);
+        genotype->saveState(1);
+        genotype->setValue(AllelesBitSet<32>(alleles));
+        genotype->acceptState();
+    };
+
+    int ps2Changes = 0;
+    int ps3Changes = 0;
+    ps2->add_element_changed_listener([&](const auto& el) { ps2Changes++; ASSERT_EQ(el, inf1); });
+    ps3->add_element_changed_listener([&](const auto& el) { ps3Changes++; ASSERT_EQ(el, inf2); });
+
+    setGenotype(inf1, "1000");
+    ASSERT_EQ(ps2Changes, 1);
+    ASSERT_EQ(ps3Changes, 0);
+
+    setGenotype(inf2, "1000");
+    ASSERT_EQ(ps2Changes, 1);
+    ASSERT_EQ(ps3Changes, 1);
+
+    // inf3 is not an allowed parent of anything
+    setGenotype(inf3, "1000");
+    ASSERT_EQ(ps2Changes, 1);
+    ASSERT_EQ(ps3Changes, 1);
+
+    // Allowing a parent again does not route its changes twice
+    ps2->addAllowedParent(inf1);
+    setGenotype(inf1, "0100");
+    ASSERT_EQ(ps2Changes, 2);
+    ASSERT_EQ(ps3Changes, 1);
+}
@@ -61,4 +61,138 @@ TEST(MultinomialSourceTransmissionProcessTest, BasicTest) {
     EXPECT_FALSE(mstp.isDirty());
     EXPECT_FALSE(coip->isDirty());
     std::cout << "LogLikelihood: " << mstp.value() << std::endl;
-}
\ No newline at end of file
+}
+
+TEST(MultinomialSourceTransmissionProcessTest, COIUpdatesReuseLocusLikelihoods) {
+    using GeneticsImpl             = AllelesBitSet<MAX_ALLELES>;
+    using COIProbabilityImpl       = ZTGeometric<MAX_COI>;
+    using AlleleFrequencyImpl      = Simplex;
+    using AlleleFrequencyContainer = AlleleFrequencyContainer<AlleleFrequencyImpl, Locus>;
+    using Infection                = Infection<GeneticsImpl, Locus>;
+    using SourceTransmissionImpl   = MultinomialSourceTransmissionProcess<COIProbabilityImpl, AlleleFrequencyContainer, Infection::GenotypeParameterMap, MAX_COI>;
+
+    auto as1 = std::make_shared<Locus>("AS1", 3);
+    auto as2 = std::make_shared<Locus>("AS2", 4);
+
+    auto inf1 = std::make_shared<Infection>("inf1", 10.0, false);
+    inf1->addGenetics(as1, "011", "011");
+    inf1->addGenetics(as2, "1011", "1011");
+
+    auto alleleFreqs = std::make_shared<AlleleFrequencyContainer>();
+    alleleFreqs->addLocus(as1);
+    alleleFreqs->alleleFrequencies(as1)->initializeValue({.2, .3, .5});
+    alleleFreqs->addLocus(as2);
+    alleleFreqs->alleleFrequencies(as2)->initializeValue({.1, .2, .3, .4});
+
+    auto coiProb = std::make_shared<Parameter<double>>(.3);
+    auto coip    = std::make_shared<COIProbabilityImpl>(coiProb);
+
+    SourceTransmissionImpl mstp(coip, alleleFreqs, inf1->loci(), inf1->latentGenotype());
+    const auto initial = mstp.value();
+    ASSERT_TRUE(std::isfinite(initial));
+    EXPECT_DOUBLE_EQ(initial, mstp.validate());
+
+    coiProb->saveState(1);
+    coiProb->setValue(.6);
+    EXPECT_TRUE(mstp.isDirty());
+    const auto updated = mstp.value();
+    EXPECT_NE(updated, initial);
+    // The reference process registers listeners on the shared parameters, so it must outlive them
+    SourceTransmissionImpl reference(coip, alleleFreqs, inf1->loci(), inf1->latentGenotype());
+    EXPECT_DOUBLE_EQ(updated, reference.value());
+    coiProb->restoreState(1);
+    EXPECT_DOUBLE_EQ(mstp.value(), initial);
+
+    // Genotype change followed by a COI change within the same proposal
+    auto genotype = inf1->latentGenotype(as2);
+    genotype->saveState(2);
+    coiProb->saveState(2);
+    genotype->setValue(GeneticsImpl("0011"));
+    coiProb->setValue(.1);
+    const auto proposed = mstp.value();
+    EXPECT_DOUBLE_EQ(proposed, mstp.validate());
+    genotype->restoreState(2);
+    coiProb->restoreState(2);
+    EXPECT_DOUBLE_EQ(mstp.value(), initial);
+}
+
+
+TEST(MultinomialSourceTransmissionProcessTest, SharedLocusCache) {
+    using GeneticsImpl             = AllelesBitSet<MAX_ALLELES>;
+    using COIProbabilityImpl       = ZTGeometric<MAX_COI>;
+    using AlleleFrequencyImpl      = Simplex;
+    using AlleleFrequencyContainer = AlleleFrequencyContainer<AlleleFrequencyImpl, Locus>;
+    using Infection                = Infection<GeneticsImpl, Locus>;
+    using SourceTransmissionImpl   = MultinomialSourceTransmissionProcess<COIProbabilityImpl, AlleleFrequencyContainer, Infection::GenotypeParameterMap, MAX_COI>;
+
+    auto as1 = std::make_shared<Locus>("AS1", 3);
+    auto as2 = std::make_shared<Locus>("AS2", 4);
+
+    auto inf1 = std::make_shared<Infection>("inf1", 10.0, false);
+    inf1->addGenetics(as1, "011", "011");
+    inf1->addGenetics(as2, "1011", "1011");
+
+    // shares the genotype at AS1 with inf1
+    auto inf2 = std::make_shared<Infection>("inf2", 10.0, false);
+    inf2->addGenetics(as1, "011", "011");
+    inf2->addGenetics(as2, "0100", "0100");
+
+    auto alleleFreqs = std::make_shared<AlleleFrequencyContainer>();
+    alleleFreqs->addLocus(as1);
+    alleleFreqs->alleleFrequencies(as1)->initializeValue({.2, .3, .5});
+    alleleFreqs->addLocus(as2);
+    alleleFreqs->alleleFrequencies(as2)->initializeValue({.1, .2, .3, .4});
+
+    auto coiProb = std::make_shared<Parameter<double>>(.3);
+    auto coip    = std::make_shared<COIProbabilityImpl>(coiProb);
+
+    auto locusCache = std::make_shared<SourceTransmissionImpl::LocusCache>(alleleFreqs);
+    SourceTransmissionImpl mstp1(coip, alleleFreqs, inf1->loci(), inf1->latentGenotype(), false, locusCache);
+    SourceTransmissionImpl mstp2(coip, alleleFreqs, inf2->loci(), inf2->latentGenotype(), false, locusCache);
+    SourceTransmissionImpl reference1(coip, alleleFreqs, inf1->loci(), inf1->latentGenotype());
+    SourceTransmissionImpl reference2(coip, alleleFreqs, inf2->loci(), inf2->latentGenotype());
+
+    EXPECT_DOUBLE_EQ(mstp1.value(), reference1.value());
+    EXPECT_DOUBLE_EQ(mstp2.value(), reference2.value());
+    EXPECT_EQ(locusCache->size(as1), 1);
+    EXPECT_EQ(locusCache->size(as2), 2);
+
+    const auto initial1 = mstp1.value();
+    const auto initial2 = mstp2.value();
+
+    // An allele frequency update invalidates only the locus it touches
+    auto af1 = alleleFreqs->alleleFrequencies(as1);
+    const auto as2Version = locusCache->version(as2);
+    af1->saveState(1);
+    af1->setValue({.5, .3, .2});
+    EXPECT_EQ(locusCache->version(as2), as2Version);
+    EXPECT_DOUBLE_EQ(mstp1.value(), reference1.value());
+    EXPECT_DOUBLE_EQ(mstp2.value(), reference2.value());
+    EXPECT_NE(mstp1.value(), initial1);
+
+    af1->restoreState(1);
+    EXPECT_DOUBLE_EQ(mstp1.value(), initial1);
+    EXPECT_DOUBLE_EQ(mstp2.value(), initial2);
+
+    // Entries computed under the restored frequencies are not reused after a new update
+    af1->saveState(2);
+    af1->setValue({.1, .1, .8});
+    auto genotype = inf2->latentGenotype(as1);
+    genotype->saveState(2);
+    genotype->setValue(GeneticsImpl("110"));
+    EXPECT_DOUBLE_EQ(mstp1.value(), reference1.value());
+    EXPECT_DOUBLE_EQ(mstp2.value(), reference2.value());
+    af1->acceptState();
+    genotype->acceptState();
+    EXPECT_DOUBLE_EQ(mstp1.value(), mstp1.validate());
+    EXPECT_DOUBLE_EQ(mstp2.value(), mstp2.validate());
+
+    // Accepting an update drops the entries computed under earlier frequencies
+    EXPECT_EQ(locusCache->size(as1), 2);
+    af1->saveState(3);
+    af1->setValue({.3, .3, .4});
+    EXPECT_DOUBLE_EQ(mstp1.value(), reference1.value());
+    af1->acceptState();
+    EXPECT_EQ(locusCache->size(as1), 1);
+    EXPECT_EQ(locusCache->size(as2), 2);
+}
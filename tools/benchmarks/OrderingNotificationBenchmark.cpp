@@ -0,0 +1,130 @@
+#include "core/computation/ObservationTimeDerivedOrdering.h"
+#include "core/computation/OrderDerivedParentSet.h"
+#include "core/containers/Infection.h"
+#include "core/containers/Locus.h"
+#include "core/datatypes/Alleles.h"
+#include "core/utils/timers.h"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace transmission_nets::core;
+using namespace transmission_nets::core::utils;
+
+namespace {
+    constexpr int TOTAL_INFECTIONS = 300;
+    constexpr int ITERATIONS       = 20'000;
+    constexpr int SPARSE_WINDOW    = 10;
+
+    using GeneticsImpl   = datatypes::AllelesBitSet<32>;
+    using InfectionEvent = containers::Infection<GeneticsImpl>;
+    using OrderingImpl   = computation::ObservationTimeDerivedOrdering<InfectionEvent>;
+    using ParentSetImpl  = computation::OrderDerivedParentSet<InfectionEvent, OrderingImpl>;
+
+}// namespace
+
+namespace transmission_nets::benchmarks {
+    // Bare keyed event with the same shape as the ordering events, to time dispatch on its own
+    class KeyedEmitter : public core::abstract::Observable<KeyedEmitter> {
+        using MovedCallback = std::function<void(std::shared_ptr<InfectionEvent> element)>;
+        CREATE_KEYED_EVENT(moved, std::shared_ptr<InfectionEvent>, MovedCallback);
+
+    public:
+        void registerKey(const std::shared_ptr<InfectionEvent>& key) {
+            register_moved_listener_key(key);
+        }
+    };
+}// namespace transmission_nets::benchmarks
+
+namespace {
+    struct Timings {
+        double moveSeconds;
+        double changeSeconds;
+        std::size_t events;
+    };
+
+    // Each infection allows the `window` infections observed before it as parents, or every other infection if window is 0
+    Timings runOrdering(const int window) {
+        auto locus = std::make_shared<containers::Locus>("L1", 8);
+
+        std::vector<std::shared_ptr<InfectionEvent>> infections;
+        for (int i = 0; i < TOTAL_INFECTIONS; ++i) {
+            auto inf = std::make_shared<InfectionEvent>(fmt::format("{}", i), static_cast<double>(i));
+            inf->addGenetics(locus, "10000001", "10000001");
+            infections.push_back(inf);
+        }
+
+        auto ordering = std::make_shared<OrderingImpl>(infections);
+        std::vector<std::shared_ptr<ParentSetImpl>> parentSets;
+        for (int i = 0; i < TOTAL_INFECTIONS; ++i) {
+            const auto first = window == 0 ? infections.begin() : infections.begin() + std::max(0, i - window);
+            const auto last  = window == 0 ? infections.end() : infections.begin() + i;
+            parentSets.push_back(std::make_shared<ParentSetImpl>(ordering, infections[i], std::vector(first, last)));
+        }
+
+        Timings timings{};
+        for (const auto& ps : parentSets) {
+            ps->add_element_added_listener([&](const auto&) { timings.events++; });
+            ps->add_element_removed_listener([&](const auto&) { timings.events++; });
+            ps->add_element_changed_listener([&](const auto&) { timings.events++; });
+        }
+
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> pick(0, TOTAL_INFECTIONS - 1);
+        std::uniform_real_distribution<double> duration(1.0, 30.0);
+
+        // Moving an infection in the ordering notifies either the parent sets it passed or the ones that allow it, whichever is fewer
+        auto t0 = timers::time();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            infections[pick(rng)]->infectionDuration()->setValue(duration(rng));
+        }
+        auto t1             = timers::time();
+        timings.moveSeconds = timers::dsec(t1 - t0).count();
+
+        // A genotype change is routed through element_changed to the parent sets that allow the infection as a parent
+        t0 = timers::time();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            infections[pick(rng)]->latentGenotype(locus)->setValue(GeneticsImpl(i % 2 ? "11000001" : "10000001"));
+        }
+        t1                    = timers::time();
+        timings.changeSeconds = timers::dsec(t1 - t0).count();
+        return timings;
+    }
+}// namespace
+
+int main() {
+    const auto dense  = runOrdering(0);
+    const auto sparse = runOrdering(SPARSE_WINDOW);
+
+    std::vector<std::shared_ptr<InfectionEvent>> infections;
+    for (int i = 0; i < TOTAL_INFECTIONS; ++i) {
+        infections.push_back(std::make_shared<InfectionEvent>(fmt::format("{}", i), static_cast<double>(i)));
+    }
+
+    // Dispatch alone, one listener per key capturing a shared pointer as the parent sets do
+    transmission_nets::benchmarks::KeyedEmitter emitter;
+    std::size_t dispatched = 0;
+    for (const auto& inf : infections) {
+        emitter.registerKey(inf);
+        emitter.add_keyed_moved_listener(inf, [&dispatched, inf](std::shared_ptr<InfectionEvent> element) {
+            dispatched += element != inf;
+        });
+    }
+    const auto t0 = timers::time();
+    for (int i = 0; i < 100 * ITERATIONS; ++i) {
+        emitter.keyed_notify_moved(infections[i % TOTAL_INFECTIONS], infections[(i + 1) % TOTAL_INFECTIONS]);
+    }
+    const auto t1                = timers::time();
+    const double dispatchSeconds = timers::dsec(t1 - t0).count();
+
+    fmt::print("infections: {}, parent set events: {}/{}, keyed events: {}\n", TOTAL_INFECTIONS, dense.events, sparse.events, dispatched);
+    fmt::print("ordering move:   {:.2f} us/update (all allowed), {:.2f} us/update ({} allowed)\n",
+               dense.moveSeconds / ITERATIONS * 1e6, sparse.moveSeconds / ITERATIONS * 1e6, SPARSE_WINDOW);
+    fmt::print("genotype change: {:.2f} us/update (all allowed), {:.2f} us/update ({} allowed)\n",
+               dense.changeSeconds / ITERATIONS * 1e6, sparse.changeSeconds / ITERATIONS * 1e6, SPARSE_WINDOW);
+    fmt::print("keyed dispatch:  {:.1f} ns/event\n", dispatchSeconds / (100 * ITERATIONS) * 1e9);
+}
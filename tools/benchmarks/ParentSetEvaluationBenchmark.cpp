@@ -0,0 +1,130 @@
+#include "core/computation/ObservationTimeDerivedOrdering.h"
+#include "core/computation/OrderDerivedParentSet.h"
+#include "core/containers/AlleleFrequencyContainer.h"
+#include "core/containers/Infection.h"
+#include "core/containers/Locus.h"
+#include "core/datatypes/Alleles.h"
+#include "core/datatypes/Simplex.h"
+#include "core/distributions/ZTGeometric.h"
+#include "core/distributions/ZTPoisson.h"
+#include "core/utils/timers.h"
+
+#include "model/transmission_process/OrderBasedTransmissionProcessV3.h"
+#include "model/transmission_process/node_transmission_process/MultinomialTransmissionProcess.h"
+#include "model/transmission_process/source_transmission_process/MultinomialSourceTransmissionProcess.h"
+
+#include <fmt/core.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace transmission_nets::core;
+using namespace transmission_nets::core::utils;
+using namespace transmission_nets::model::transmission_process;
+
+namespace {
+    constexpr int MAX_PARENTS   = 2;
+    constexpr int MAX_ALLELES   = 32;
+    constexpr int MAX_COI       = 10;
+    constexpr int MAX_STRAINS   = 12;
+    constexpr int TOTAL_PARENTS = 24;
+    constexpr int TOTAL_LOCI    = 24;
+    constexpr int TOTAL_ALLELES = 8;
+    constexpr int ITERATIONS    = 2'000;
+
+    using GeneticsImpl                 = datatypes::AllelesBitSet<MAX_ALLELES>;
+    using InfectionEvent               = containers::Infection<GeneticsImpl>;
+    using AlleleFrequencyContainerImpl = containers::AlleleFrequencyContainer<datatypes::Simplex>;
+    using OrderingImpl                 = computation::ObservationTimeDerivedOrdering<InfectionEvent>;
+    using ParentSetImpl                = computation::OrderDerivedParentSet<InfectionEvent, OrderingImpl>;
+
+    using COIProbabilityImpl          = distributions::ZTPoisson<MAX_COI>;
+    using ParentSetSizeLikelihoodImpl = distributions::ZTGeometric<MAX_PARENTS + 1>;
+    using SourceTransmissionImpl      = MultinomialSourceTransmissionProcess<COIProbabilityImpl, AlleleFrequencyContainerImpl, InfectionEvent::GenotypeParameterMap, MAX_COI>;
+    using NodeTransmissionImpl        = MultinomialTransmissionProcess<MAX_PARENTS, MAX_STRAINS, SourceTransmissionImpl, ParentSetSizeLikelihoodImpl>;
+    using TransmissionProcess         = OrderBasedTransmissionProcessV3<MAX_PARENTS, NodeTransmissionImpl, SourceTransmissionImpl, ParentSetSizeLikelihoodImpl, InfectionEvent, ParentSetImpl>;
+
+    std::string randomGenotype(std::mt19937& rng, const double density) {
+        std::bernoulli_distribution present(density);
+        std::string genotype(TOTAL_ALLELES, '0');
+        for (auto& allele : genotype) {
+            allele = present(rng) ? '1' : '0';
+        }
+        genotype[rng() % TOTAL_ALLELES] = '1';
+        return genotype;
+    }
+
+    /*
+     * A child with TOTAL_PARENTS candidate parents, re-evaluated after a genotype change at one of its loci. The change
+     * applies to every cached parent set, so each evaluation recalculates that locus for all parent sets and screens all
+     * loci for coverage.
+     */
+    double secondsPerEvaluation() {
+        std::mt19937 rng(42);
+
+        std::vector<std::shared_ptr<containers::Locus>> loci;
+        auto afc = std::make_shared<AlleleFrequencyContainerImpl>();
+        for (int i = 0; i < TOTAL_LOCI; ++i) {
+            loci.push_back(std::make_shared<containers::Locus>(fmt::format("L{}", i), TOTAL_ALLELES, i));
+            afc->addLocus(loci.back());
+        }
+
+        std::vector<std::shared_ptr<InfectionEvent>> infections;
+        for (int i = 0; i <= TOTAL_PARENTS; ++i) {
+            auto inf = std::make_shared<InfectionEvent>(fmt::format("{}", i), static_cast<double>(i), false);
+            for (const auto& locus : loci) {
+                const auto genotype = randomGenotype(rng, 0.4);
+                inf->addGenetics(locus, genotype, genotype);
+            }
+            infections.push_back(inf);
+        }
+        const auto child        = infections.back();
+        const auto latentParent = std::make_shared<InfectionEvent>(*child);
+
+        auto ordering  = std::make_shared<OrderingImpl>(infections);
+        auto parentSet = std::make_shared<ParentSetImpl>(ordering, child, std::vector(infections.begin(), infections.end() - 1));
+
+        auto psp = std::make_shared<ParentSetSizeLikelihoodImpl>(std::make_shared<parameters::Parameter<double>>(.8));
+        auto ntp = std::make_shared<NodeTransmissionImpl>(std::make_shared<parameters::Parameter<double>>(1.5));
+        auto stp = std::make_shared<SourceTransmissionImpl>(std::make_shared<COIProbabilityImpl>(std::make_shared<parameters::Parameter<double>>(2.0)), afc, latentParent->loci(), latentParent->latentGenotype());
+        auto tp  = std::make_shared<TransmissionProcess>(ntp, stp, psp, child, parentSet, latentParent);
+
+        std::vector<GeneticsImpl> proposals;
+        for (int i = 0; i < ITERATIONS; ++i) {
+            proposals.emplace_back(randomGenotype(rng, 0.4));
+        }
+
+        double checksum = 0;
+        const auto t0   = timers::time();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            const auto& genotype = child->latentGenotype(loci[i % TOTAL_LOCI]);
+            genotype->saveState(1);
+            genotype->setValue(proposals[i]);
+            checksum += tp->value();
+            genotype->acceptState();
+        }
+        const auto t1 = timers::time();
+
+        if (checksum == 0) {
+            fmt::print("unexpected checksum\n");
+        }
+        return timers::dsec(t1 - t0).count() / ITERATIONS;
+    }
+}// namespace
+
+int main() {
+    constexpr int parentSets = TOTAL_PARENTS + TOTAL_PARENTS * (TOTAL_PARENTS - 1) / 2;
+
+    // While the process has a single thread the standard library updates reference counts without atomic instructions,
+    // once a second thread has been started every update is a locked read-modify-write, as in the multi chain sampler.
+    const double singleThreaded = secondsPerEvaluation();
+    std::thread([] {}).join();
+    const double multiThreaded = secondsPerEvaluation();
+
+    fmt::print("parents: {}, loci: {}, parent sets per evaluation: {}\n", TOTAL_PARENTS, TOTAL_LOCI, 2 * parentSets + 1);
+    fmt::print("evaluation: {:.1f} us (non-atomic reference counts), {:.1f} us (atomic reference counts)\n",
+               singleThreaded * 1e6, multiThreaded * 1e6);
+}
@@ -0,0 +1,71 @@
+#include "core/utils/ProbAnyMissing.h"
+#include "core/utils/timers.h"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+using namespace transmission_nets::core::utils;
+
+namespace {
+    constexpr unsigned int MAX_STRAINS = 12;
+    constexpr int ITERATIONS           = 1'000'000;
+    constexpr int SETS                 = 64;
+
+    // Random event probabilities for SETS genotypes with totalEvents alleles present
+    std::vector<Likelihood> eventProbSets(std::size_t totalEvents, std::mt19937& rng) {
+        std::uniform_real_distribution<Likelihood> dist(0.01, 1.0);
+        std::vector<Likelihood> probs(SETS * totalEvents);
+        for (int s = 0; s < SETS; ++s) {
+            Likelihood total = 0.0;
+            for (std::size_t e = 0; e < totalEvents; ++e) {
+                probs[s * totalEvents + e] = dist(rng);
+                total += probs[s * totalEvents + e];
+            }
+            // the present alleles carry most, but not all, of the frequency mass
+            for (std::size_t e = 0; e < totalEvents; ++e) {
+                probs[s * totalEvents + e] *= .9 / total;
+            }
+        }
+        return probs;
+    }
+
+    template<typename F>
+    double nsPerCall(const std::vector<Likelihood>& probs, std::size_t totalEvents, Likelihood& checksum, F&& f) {
+        std::array<Likelihood, MAX_STRAINS> out{};
+        const auto t0 = timers::time();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            f(probs.data() + (i % SETS) * totalEvents, out.data());
+            checksum += out[MAX_STRAINS - 1];
+        }
+        const auto t1 = timers::time();
+        return std::chrono::duration<double, std::nano>(t1 - t0).count() / ITERATIONS;
+    }
+}// namespace
+
+int main() {
+    probAnyMissingFunctor probAnyMissing;
+    std::mt19937 rng(42);
+    Likelihood checksum = 0.0;
+
+    fmt::print("{:>7} {:>12} {:>12} {:>13} {:>9}\n", "alleles", "scalar (ns)", "best (ns)", "dispatch (ns)", "speedup");
+    for (std::size_t totalEvents = 1; totalEvents <= 6; ++totalEvents) {
+        const auto probs = eventProbSets(totalEvents, rng);
+
+        const double scalar = nsPerCall(probs, totalEvents, checksum, [&](const Likelihood* p, Likelihood* out) {
+            probAnyMissing.vectorized(p, totalEvents, MAX_STRAINS, out, probAnyMissingFunctor::Kernel::Scalar);
+        });
+        const double best = nsPerCall(probs, totalEvents, checksum, [&](const Likelihood* p, Likelihood* out) {
+            probAnyMissing.vectorized(p, totalEvents, MAX_STRAINS, out, probAnyMissingFunctor::bestKernel());
+        });
+        const double dispatch = nsPerCall(probs, totalEvents, checksum, [&](const Likelihood* p, Likelihood* out) {
+            probAnyMissing.vectorized(p, totalEvents, MAX_STRAINS, out);
+        });
+
+        fmt::print("{:>7} {:>12.1f} {:>12.1f} {:>13.1f} {:>8.2f}x\n", totalEvents, scalar, best, dispatch, std::min(scalar, best) / dispatch);
+    }
+    fmt::print("checksum: {}\n", checksum);
+}
@@ -75,6 +75,8 @@ int main(int argc, char** argv) {
 //    try {
         int num_chains;
         unsigned int num_cores;
+        int likelihood_cores;
+        std::size_t parallel_threshold;
         Probability gradient;
 
         int burnin;
@@ -97,6 +99,8 @@ int main(int argc, char** argv) {
         opts("thin,t", po::value<int>(&thin)->default_value(1000), "Number of steps to be thinned");
         opts("numchains,n", po::value<int>(&num_chains)->default_value(1), "Number of chains to run in replica exchange algorithm.");
         opts("numcores,c", po::value<unsigned int>(&num_cores)->default_value(1), "Number of cores to use in replica exchange algorithm.");
+        opts("likelihood-cores", po::value<int>(&likelihood_cores)->default_value(1), "Number of cores each chain uses to evaluate the likelihood terms changed by a proposal.");
+        opts("parallel-threshold", po::value<std::size_t>(&parallel_threshold)->default_value(64), "Fewest changed likelihood terms evaluated on more than one core.");
         opts("gradient,g", po::value<Probability>(&gradient)->default_value(0), "Lower temperature of gradient to use in replica exchange algorithm");
         opts("seed", po::value<long>(&seed)->default_value(-1), "Seed used in random number generator. Note that if numchains > 1 then there is no guarantee of reproducibility. A value of -1 indicates generate a random seed.");
         opts("hotload,h", "Hotload parameters from the output directory");
@@ -182,6 +186,16 @@ int main(int argc, char** argv) {
         auto r = std::make_shared<boost::random::mt19937>(seed);
         repex  = std::make_unique<ReplicaExchange<Model::State, Model::Model, Model::SequentialSampleScheduler, Model::ModelLogger, Model::StateLogger>>(num_chains, thin, gradient, r, outputDir, hotload, null_model, num_cores, j, symptomatic_idp, asymptomatic_idp);
 
+        if (likelihood_cores > 1) {
+            for (auto& chain : repex->chains) {
+                chain.model->setParallelEvaluation(parallel_threshold, likelihood_cores);
+            }
+#ifdef _OPENMP
+            // Chains are stepped in a parallel region, the likelihood needs a nested one to use more cores
+            omp_set_max_active_levels(2);
+#endif
+        }
+
         fmt::print("Starting Replica Exchange...\n");
         repex->logState();
         repex->finalize();